@@ -0,0 +1,226 @@
+// Брои заделянията на памет при зареждане на флота и при търсене, като
+// сравнява пътищата с копиране и с преместване и достъпа до низовете по
+// стойност и по препратка. Компилиране от директорията project:
+//
+//   g++ -std=c++17 -O2 -pthread -o entity_alloc_bench bench/entity_alloc_bench.cpp
+//       $(ls src/*.cpp | grep -v main.cpp)
+//
+// (двата реда са една команда).
+//
+// Низовете са по-дълги от вградения буфер на string, за да се вижда всяко
+// копие като заделяне.
+#include "../headers/FleetManager.h"
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <new>
+#include <sstream>
+
+using namespace std;
+
+namespace {
+
+atomic<size_t> allocationCount(0);
+
+const size_t AIRPLANE_COUNT = 20000;
+const size_t DESTINATION_COUNT = 2000;
+const size_t SEARCH_COUNT = 200;
+
+// setw брои байтове, а надписите са на кирилица, затова се подравняват
+// по брой символи в UTF-8.
+string padded(const string &text, size_t width) {
+    size_t characters = 0;
+    for (char c : text) {
+        characters += (static_cast<unsigned char>(c) & 0xC0) != 0x80 ? 1 : 0;
+    }
+    return characters < width ? text + string(width - characters, ' ') : text;
+}
+
+template <typename Work>
+void measure(const string &label, size_t operations, Work work) {
+    size_t before = allocationCount.load();
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    work();
+    chrono::duration<double, milli> elapsed = chrono::steady_clock::now() - start;
+    size_t allocations = allocationCount.load() - before;
+    cout << padded(label, 52) << setw(10) << allocations << setw(10)
+         << fixed << setprecision(2) << static_cast<double>(allocations) / operations
+         << setw(10) << elapsed.count() << " ms" << endl;
+}
+
+string numbered(const string &prefix, size_t number) {
+    ostringstream text;
+    text << prefix << setw(6) << setfill('0') << number;
+    return text.str();
+}
+
+vector<PlaneClass> makePlaneClasses() {
+    vector<PlaneClass> planeClasses;
+    planeClasses.push_back(PlaneClass("Boeing Commercial", "737-800 Next Gen", 189, 2500.0, 0.03,
+                                      26020.0, 842.0, 5));
+    planeClasses.push_back(PlaneClass("Airbus Industrie", "A320neo Family", 180, 2100.0, 0.028,
+                                      24210.0, 840.0, 4));
+    planeClasses.push_back(PlaneClass("Embraer Aviation", "E190-E2 Regional", 114, 2000.0, 0.032,
+                                      13230.0, 823.0, 4));
+    return planeClasses;
+}
+
+vector<Airplane> makeAirplanes(const vector<PlaneClass> &planeClasses) {
+    vector<shared_ptr<const PlaneClass> > shared;
+    for (const auto &planeClass : planeClasses) {
+        shared.push_back(make_shared<PlaneClass>(planeClass));
+    }
+    vector<Airplane> airplanes;
+    airplanes.reserve(AIRPLANE_COUNT);
+    for (size_t i = 0; i < AIRPLANE_COUNT; ++i) {
+        airplanes.push_back(Airplane(numbered("LZ-FLEET-AIRPLANE-", i), shared[i % shared.size()],
+                                     i % 5 != 0, numbered("BASE-AIRPORT-", i % 40), 0));
+    }
+    return airplanes;
+}
+
+vector<Destination> makeDestinations() {
+    vector<Destination> destinations;
+    destinations.reserve(DESTINATION_COUNT);
+    for (size_t i = 0; i < DESTINATION_COUNT; ++i) {
+        destinations.push_back(Destination(numbered("BASE-AIRPORT-", i), numbered("Летище ", i),
+                                           "Град на дестинацията", "Държава на дестинацията",
+                                           1800.0 + (i % 20) * 100.0, 300.0 + (i % 50) * 150.0,
+                                           -60.0 + (i % 120), -170.0 + (i % 340)));
+    }
+    return destinations;
+}
+
+}
+
+// GCC смята malloc в заменения operator new за несъвместим с operator delete.
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+
+void *operator new(size_t size) {
+    allocationCount.fetch_add(1, memory_order_relaxed);
+    void *memory = malloc(size == 0 ? 1 : size);
+    if (memory == nullptr) {
+        throw bad_alloc();
+    }
+    return memory;
+}
+
+void operator delete(void *memory) noexcept { free(memory); }
+
+void operator delete(void *memory, size_t) noexcept { free(memory); }
+
+int main() {
+    vector<PlaneClass> planeClasses = makePlaneClasses();
+    cout << padded("Сценарий", 52) << padded("Заделяния", 10) << padded("На опер.", 10)
+         << "Време" << endl;
+
+    // Зареждане: едни и същи данни през const& (копие) и през && (преместване).
+    {
+        vector<Airplane> airplanes = makeAirplanes(planeClasses);
+        vector<Destination> destinations = makeDestinations();
+        FleetManager fleet("Сравнение", "./bench-data");
+        fleet.addPlaneClasses(planeClasses);
+        measure("addDestination(const Destination&)", DESTINATION_COUNT, [&]() {
+            for (const auto &destination : destinations) {
+                fleet.addDestination(destination);
+            }
+        });
+        measure("addAirplane(const Airplane&)", AIRPLANE_COUNT, [&]() {
+            for (const auto &airplane : airplanes) {
+                fleet.addAirplane(airplane);
+            }
+        });
+    }
+    {
+        vector<Airplane> airplanes = makeAirplanes(planeClasses);
+        vector<Destination> destinations = makeDestinations();
+        FleetManager fleet("Сравнение", "./bench-data");
+        fleet.addPlaneClasses(planeClasses);
+        measure("addDestination(Destination&&)", DESTINATION_COUNT, [&]() {
+            for (auto &destination : destinations) {
+                fleet.addDestination(move(destination));
+            }
+        });
+        measure("addAirplane(Airplane&&)", AIRPLANE_COUNT, [&]() {
+            for (auto &airplane : airplanes) {
+                fleet.addAirplane(move(airplane));
+            }
+        });
+    }
+    {
+        vector<Airplane> airplanes = makeAirplanes(planeClasses);
+        measure("vector<Airplane> с копиране при растеж", AIRPLANE_COUNT, [&]() {
+            vector<Airplane> grown;
+            for (const auto &airplane : airplanes) {
+                grown.push_back(airplane);
+            }
+        });
+        measure("vector<Airplane> с преместване при растеж", AIRPLANE_COUNT, [&]() {
+            vector<Airplane> grown;
+            for (auto &airplane : airplanes) {
+                grown.push_back(move(airplane));
+            }
+        });
+    }
+
+    // Търсене: линейни обхождания, които сравняват низове, и заявката за
+    // самолетите до дестинация.
+    FleetManager fleet("Търсене", "./bench-data");
+    fleet.addPlaneClasses(planeClasses);
+    fleet.addDestinations(makeDestinations());
+    fleet.addAirplanes(makeAirplanes(planeClasses));
+    const vector<Airplane> &airplanes = fleet.getAirplanes();
+    const vector<Destination> &destinations = fleet.getDestinations();
+    string wantedClass = planeClasses.back().getClassId();
+    size_t matches = 0;
+
+    measure("getClassId() == клас, по стойност", SEARCH_COUNT * AIRPLANE_COUNT, [&]() {
+        for (size_t search = 0; search < SEARCH_COUNT; ++search) {
+            for (const auto &airplane : airplanes) {
+                matches += airplane.getPlaneClassRef().getClassId() == wantedClass ? 1 : 0;
+            }
+        }
+    });
+    measure("getClassIdRef() == клас, по препратка", SEARCH_COUNT * AIRPLANE_COUNT, [&]() {
+        for (size_t search = 0; search < SEARCH_COUNT; ++search) {
+            for (const auto &airplane : airplanes) {
+                matches += airplane.getPlaneClassRef().getClassIdRef() == wantedClass ? 1 : 0;
+            }
+        }
+    });
+    measure("getBaseAirportCode() == код, по стойност", SEARCH_COUNT * AIRPLANE_COUNT, [&]() {
+        for (size_t search = 0; search < SEARCH_COUNT; ++search) {
+            const string &code = destinations[search].getCodeRef();
+            for (const auto &airplane : airplanes) {
+                matches += airplane.getBaseAirportCode() == code ? 1 : 0;
+            }
+        }
+    });
+    measure("getBaseAirportCodeRef() == код, по препратка", SEARCH_COUNT * AIRPLANE_COUNT, [&]() {
+        for (size_t search = 0; search < SEARCH_COUNT; ++search) {
+            const string &code = destinations[search].getCodeRef();
+            for (const auto &airplane : airplanes) {
+                matches += airplane.getBaseAirportCodeRef() == code ? 1 : 0;
+            }
+        }
+    });
+
+    shared_ptr<const FleetSnapshot> snapshot = fleet.takeSnapshot();
+    measure("FleetSnapshot::findAirplanesForDestination", SEARCH_COUNT, [&]() {
+        for (size_t search = 0; search < SEARCH_COUNT; ++search) {
+            matches += snapshot->findAirplanesForDestination(destinations[search].getCodeRef())
+                           .size();
+        }
+    });
+    fleet.findAirplaneHandlesForDestination(destinations[0].getCodeRef());
+    measure("FleetManager::findAirplaneHandlesForDestination", SEARCH_COUNT, [&]() {
+        for (size_t search = 0; search < SEARCH_COUNT; ++search) {
+            matches += fleet.findAirplaneHandlesForDestination(destinations[search].getCodeRef())
+                           .size();
+        }
+    });
+
+    cout << "Съвпадения (за да не отпадне работата): " << matches << endl;
+    return 0;
+}
@@ -8,10 +8,12 @@
 
 using namespace std;
 
+const double FUEL_PRICE_PER_LITER = 0.80;
+
 class Airplane {
 private:
     string identificationNumber_;
-    PlaneClass planeClass_;
+    shared_ptr<const PlaneClass> planeClass_;
     bool isOperational_;
     string baseAirportCode_;
     int totalFlightHours_;
@@ -21,27 +23,36 @@ public:
     Airplane(const string& id, const PlaneClass& planeClass);
     Airplane(const string& id, const PlaneClass& planeClass,
              bool operational, const string& baseAirport, int flightHours);
+    // Низовете се приемат по стойност, за да може зареждането да ги премести.
+    Airplane(string id, const shared_ptr<const PlaneClass>& planeClass,
+             bool operational, string baseAirport, int flightHours);
     Airplane(const Airplane& other);
+    Airplane(Airplane&& other) noexcept;
     ~Airplane();
 
     string getIdentificationNumber() const;
+    const string& getIdentificationNumberRef() const;
     PlaneClass getPlaneClass() const;
     bool isOperational() const;
     string getBaseAirportCode() const;
+    const string& getBaseAirportCodeRef() const;
     int getTotalFlightHours() const;
 
-    void setIdentificationNumber(const string& id);
+    void setIdentificationNumber(string id);
     void setPlaneClass(const PlaneClass& planeClass);
+    void setPlaneClass(const shared_ptr<const PlaneClass>& planeClass);
     void setOperational(bool operational);
     void setBaseAirportCode(const string& code);
     void setTotalFlightHours(int hours);
 
     const PlaneClass& getPlaneClassRef() const;
+    const shared_ptr<const PlaneClass>& getSharedPlaneClass() const;
     bool canFlyToDestination(double runwayLength, double distance) const;
     double calculateOperatingCost(double distanceKm, int passengers) const;
     void addFlightHours(int hours);
 
     Airplane& operator=(const Airplane& other);
+    Airplane& operator=(Airplane&& other) noexcept;
     friend ostream& operator<<(ostream& os, const Airplane& airplane);
     friend istream& operator>>(istream& is, Airplane& airplane);
     bool operator==(const Airplane& other) const;
@@ -0,0 +1,98 @@
+#ifndef BINARY_SNAPSHOT_H
+#define BINARY_SNAPSHOT_H
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+#include <cstddef>
+
+using namespace std;
+
+// Двоичен формат на моментна снимка на флота. Записите са с фиксирана
+// дължина и подравнени на 8 байта, а низовете се пазят в обща таблица
+// и се адресират с (отместване, дължина). Целият файл след заглавието
+// е покрит от контролна сума FNV-1a.
+const char SNAPSHOT_MAGIC[8] = {'F', 'L', 'E', 'E', 'T', 'S', 'N', 'P'};
+const uint32_t SNAPSHOT_VERSION = 2;
+const char SNAPSHOT_FILE_NAME[] = "fleet.snapshot";
+
+struct SnapshotString {
+    uint32_t offset;
+    uint32_t length;
+};
+
+struct SnapshotHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t headerSize;
+    uint32_t planeClassCount;
+    uint32_t airplaneCount;
+    uint32_t destinationCount;
+    // Поколение на файловете с данни, от които е снимката; 0 ако не е известно.
+    uint32_t generation;
+    SnapshotString companyName;
+    uint64_t planeClassOffset;
+    uint64_t airplaneOffset;
+    uint64_t destinationOffset;
+    uint64_t stringTableOffset;
+    uint64_t stringTableSize;
+    uint64_t checksum;
+};
+
+struct SnapshotPlaneClass {
+    SnapshotString manufacturer;
+    SnapshotString model;
+    double minRunwayLength;
+    double fuelConsumptionPerKmPerSeat;
+    double tankVolumeLiters;
+    double averageSpeedKmh;
+    double maxRange;
+    int32_t seatCount;
+    int32_t requiredCrewCount;
+};
+
+struct SnapshotAirplane {
+    SnapshotString identificationNumber;
+    SnapshotString baseAirportCode;
+    uint32_t planeClassIndex;
+    int32_t totalFlightHours;
+    uint8_t operational;
+    uint8_t padding[7];
+};
+
+struct SnapshotDestination {
+    SnapshotString code;
+    SnapshotString name;
+    SnapshotString city;
+    SnapshotString country;
+    double runwayLengthMeters;
+    double distanceFromBaseKm;
+    double latitude;
+    double longitude;
+    uint8_t hasCoordinates;
+    uint8_t padding[7];
+};
+
+static_assert(sizeof(SnapshotHeader) % 8 == 0, "Заглавието трябва да е подравнено на 8 байта");
+static_assert(sizeof(SnapshotPlaneClass) % 8 == 0, "Записът трябва да е подравнен на 8 байта");
+static_assert(sizeof(SnapshotAirplane) % 8 == 0, "Записът трябва да е подравнен на 8 байта");
+static_assert(sizeof(SnapshotDestination) % 8 == 0, "Записът трябва да е подравнен на 8 байта");
+
+class SnapshotStringTable {
+private:
+    string data_;
+    unordered_map<string, uint32_t> offsets_;
+
+public:
+    SnapshotStringTable();
+
+    SnapshotString add(const string& value);
+    const string& getData() const;
+};
+
+uint64_t computeSnapshotChecksum(const char* data, size_t size);
+bool isSnapshotStringValid(const SnapshotString& value, uint64_t stringTableSize);
+bool validateSnapshot(const char* data, size_t size);
+
+#endif
@@ -0,0 +1,44 @@
+#ifndef COMMAND_INTERPRETER_H
+#define COMMAND_INTERPRETER_H
+
+#include <istream>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <cstddef>
+#include "FleetManager.h"
+#include "CsvWriter.h"
+
+using namespace std;
+
+// Изпълнява текстови команди върху FleetManager без менюта и подкани.
+// Всяка команда е един ред с полета, разделени с табулация. Отговорът
+// започва с "ok<TAB>N", последван от N реда с данни, или е един ред
+// "error<TAB>код<TAB>съобщение".
+class CommandInterpreter {
+private:
+    static const size_t MAX_FIELDS = 10;
+
+    FleetManager& manager_;
+    size_t executedCount_;
+    size_t failedCount_;
+    bool readOnly_;
+
+    bool dispatch(const string_view* fields, size_t count, ostream& out);
+    static bool isMutating(string_view command);
+
+    static void writeOk(ostream& out, size_t rowCount);
+    static void writeError(ostream& out, const string& code, const string& message);
+
+public:
+    explicit CommandInterpreter(FleetManager& manager);
+
+    bool execute(string_view line, ostream& out);
+    void run(istream& in, ostream& out);
+
+    void setReadOnly(bool readOnly);
+    size_t getExecutedCount() const;
+    size_t getFailedCount() const;
+};
+
+#endif
@@ -0,0 +1,49 @@
+#ifndef COMPATIBILITY_INDEX_H
+#define COMPATIBILITY_INDEX_H
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+#include <cstddef>
+#include "Airplane.h"
+
+using namespace std;
+
+// Колонно (structure-of-arrays) копие на данните, нужни за
+// Airplane::canFlyToDestination. Позициите съвпадат с плътния масив
+// със самолети във FleetManager. Базите са номерирани, за да може
+// разстоянието до дестинацията да се подаде веднъж за база, а не за самолет.
+class CompatibilityIndex {
+private:
+    vector<double> minRunwayLengths_;
+    vector<double> maxRanges_;
+    vector<uint8_t> operational_;
+    vector<uint32_t> baseAirports_;
+    vector<string> baseAirportCodes_;
+    unordered_map<string, uint32_t> baseAirportIds_;
+
+    uint32_t baseAirportId(const string& code);
+
+public:
+    CompatibilityIndex();
+
+    size_t size() const;
+    size_t getBaseAirportCount() const;
+    const string& getBaseAirportCode(size_t baseAirport) const;
+
+    void append(const Airplane& airplane);
+    void update(size_t position, const Airplane& airplane);
+    void removeBySwapWithLast(size_t position);
+    void clear();
+
+    // Едно и също разстояние за всички самолети.
+    void findCompatible(double runwayLength, double distance,
+                        vector<uint32_t>& positions) const;
+    // baseDistances[b] е разстоянието от базата с номер b до дестинацията.
+    void findCompatible(double runwayLength, const double* baseDistances,
+                        vector<uint32_t>& positions) const;
+    void markCompatible(double runwayLength, const double* baseDistances, uint64_t* bits) const;
+};
+
+#endif
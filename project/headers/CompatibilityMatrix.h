@@ -0,0 +1,46 @@
+#ifndef COMPATIBILITY_MATRIX_H
+#define COMPATIBILITY_MATRIX_H
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include "Airplane.h"
+#include "Destination.h"
+#include "SlotMap.h"
+#include "CompatibilityIndex.h"
+
+using namespace std;
+
+class CompatibilityMatrix {
+private:
+    size_t wordsPerRow_;
+    vector<uint64_t> bits_;
+    vector<uint32_t> airplanesPerDestination_;
+    vector<uint32_t> destinationsPerAirplane_;
+    vector<SlotHandle<Destination> > destinations_;
+    vector<SlotHandle<Airplane> > airplanes_;
+
+public:
+    CompatibilityMatrix();
+
+    // Разстоянието от база b до дестинацията на ред row е
+    // baseDistances[row * index.getBaseAirportCount() + b].
+    static CompatibilityMatrix compute(const CompatibilityIndex& index,
+                                       const vector<Destination>& destinations,
+                                       const vector<double>& baseDistances,
+                                       unsigned threadCount);
+
+    size_t getDestinationCount() const;
+    size_t getAirplaneCount() const;
+    bool isCompatible(size_t destinationRow, size_t airplaneColumn) const;
+    size_t countAirplanesForDestination(size_t destinationRow) const;
+    size_t countDestinationsForAirplane(size_t airplaneColumn) const;
+    vector<size_t> getAirplaneColumns(size_t destinationRow) const;
+
+    SlotHandle<Destination> getDestinationHandle(size_t destinationRow) const;
+    SlotHandle<Airplane> getAirplaneHandle(size_t airplaneColumn) const;
+    void setHandles(const vector<SlotHandle<Destination> >& destinations,
+                    const vector<SlotHandle<Airplane> >& airplanes);
+};
+
+#endif
@@ -0,0 +1,31 @@
+#ifndef CSV_READER_H
+#define CSV_READER_H
+
+#include <istream>
+#include <string>
+#include <vector>
+#include <cstddef>
+
+using namespace std;
+
+// Поточно четене на CSV/TSV записи по RFC 4180: полета в кавички могат да
+// съдържат разделители и нови редове. В паметта е само текущият запис.
+class CsvReader {
+private:
+    istream& input_;
+    char delimiter_;
+    size_t lineNumber_;
+    size_t recordLineNumber_;
+    bool malformed_;
+
+public:
+    CsvReader(istream& input, char delimiter);
+
+    bool nextRecord(vector<string>& fields);
+    size_t getLineNumber() const;
+    bool isMalformed() const;
+
+    static char delimiterForFile(const string& filename);
+};
+
+#endif
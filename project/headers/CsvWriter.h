@@ -0,0 +1,29 @@
+#ifndef CSV_WRITER_H
+#define CSV_WRITER_H
+
+#include <ostream>
+#include <string>
+#include <string_view>
+
+using namespace std;
+
+// Записва CSV/TSV ред по ред директно в потока. Полета, съдържащи
+// разделител, кавички или нов ред, се ограждат в кавички.
+class CsvWriter {
+private:
+    ostream& output_;
+    char delimiter_;
+    bool atRecordStart_;
+
+public:
+    CsvWriter(ostream& output, char delimiter);
+
+    CsvWriter& field(string_view value);
+    CsvWriter& field(int value);
+    CsvWriter& field(size_t value);
+    CsvWriter& field(double value);
+    void endRecord();
+    bool good() const;
+};
+
+#endif
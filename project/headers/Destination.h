@@ -7,6 +7,13 @@
 
 using namespace std;
 
+const double EARTH_RADIUS_KM = 6371.0;
+
+// Разстояние по голям кръг (формула на хаверсинусите) между две точки,
+// зададени в градуси.
+double greatCircleDistanceKm(double latitude1, double longitude1,
+                             double latitude2, double longitude2);
+
 class Destination {
 private:
     string code_;
@@ -15,21 +22,35 @@ private:
     string country_;
     double runwayLengthMeters_;
     double distanceFromBaseKm_;
+    bool hasCoordinates_;
+    double latitude_;
+    double longitude_;
 
 public:
     Destination();
     Destination(const string& code, const string& name,
                 const string& city, const string& country,
                 double runwayLength, double distance);
+    Destination(const string& code, const string& name,
+                const string& city, const string& country,
+                double runwayLength, double distance, double latitude, double longitude);
     Destination(const Destination& other);
+    Destination(Destination&& other) noexcept;
     ~Destination();
 
+    Destination& operator=(const Destination& other);
+    Destination& operator=(Destination&& other) noexcept;
+
     string getCode() const;
+    const string& getCodeRef() const;
     string getName() const;
     string getCity() const;
     string getCountry() const;
     double getRunwayLengthMeters() const;
     double getDistanceFromBaseKm() const;
+    bool hasCoordinates() const;
+    double getLatitude() const;
+    double getLongitude() const;
 
     void setCode(const string& code);
     void setName(const string& name);
@@ -37,6 +58,15 @@ public:
     void setCountry(const string& country);
     void setRunwayLengthMeters(double length);
     void setDistanceFromBaseKm(double distance);
+    void setCoordinates(double latitude, double longitude);
+    void clearCoordinates();
+
+    // Разстояние по голям кръг. И двете дестинации трябва да имат координати.
+    double distanceToKm(const Destination& other) const;
+    // Разстояние от летището airport (например базата на самолет). Ако то
+    // не е известно или някое от двете няма координати, се връща
+    // записаното разстояние от базата.
+    double distanceFromAirportKm(const Destination* airport) const;
 
     string getDisplayString() const;
 
@@ -0,0 +1,39 @@
+#ifndef DISTANCE_CACHE_H
+#define DISTANCE_CACHE_H
+
+#include <string>
+#include <utility>
+#include <unordered_map>
+#include <cstddef>
+#include "Destination.h"
+
+using namespace std;
+
+// Запомнени разстояния по голям кръг между двойки летища, за да не се
+// смятат хаверсинуси при всяка проверка за съвместимост. Ключът е двойката
+// кодове в азбучен ред, защото разстоянието е симетрично.
+class DistanceCache {
+private:
+    typedef pair<string, string> AirportPair;
+
+    struct AirportPairHash {
+        size_t operator()(const AirportPair& airports) const;
+    };
+
+    unordered_map<AirportPair, double, AirportPairHash> distances_;
+
+public:
+    DistanceCache();
+
+    size_t size() const;
+
+    // Същото като destination.distanceFromAirportKm(airport), но
+    // разстоянието между летища с координати се смята само веднъж.
+    double getDistanceFromAirportKm(const Destination* airport, const Destination& destination);
+
+    // Забравя разстоянията до летището; извиква се при премахването му.
+    void forget(const string& code);
+    void clear();
+};
+
+#endif
@@ -0,0 +1,17 @@
+#ifndef DURABLE_FILE_H
+#define DURABLE_FILE_H
+
+#include <string>
+#include <cstddef>
+
+using namespace std;
+
+bool writeFileDurably(const string& path, const char* data, size_t size);
+bool writeFileDurably(const string& path, const string& contents);
+bool renameDurably(const string& from, const string& to);
+bool replaceFileAtomically(const string& path, const string& contents);
+bool syncDirectory(const string& directory);
+string getParentDirectory(const string& path);
+bool fileExists(const string& path);
+
+#endif
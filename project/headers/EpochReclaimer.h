@@ -0,0 +1,38 @@
+#ifndef EPOCH_RECLAIMER_H
+#define EPOCH_RECLAIMER_H
+
+#include <cstddef>
+
+using namespace std;
+
+// Епохово освобождаване на памет (RCU): читателите отбелязват в собствен
+// слот епохата, в която са започнали, без заключване. Писателят подменя
+// указателя към данните и предава старата версия тук; тя се изтрива едва
+// когато нито един активен читател не е започнал преди подмяната.
+class EpochReclaimer {
+public:
+    class Guard {
+    private:
+        int slot_;
+
+    public:
+        Guard();
+        ~Guard();
+        Guard(const Guard&) = delete;
+        Guard& operator=(const Guard&) = delete;
+    };
+
+    template <typename T>
+    static void retire(const T* object) {
+        retire(object, [](const void* retired) { delete static_cast<const T*>(retired); });
+    }
+
+    static void retire(const void* object, void (*deleter)(const void*));
+    static size_t reclaim();
+    static size_t getPendingCount();
+
+private:
+    EpochReclaimer() = delete;
+};
+
+#endif
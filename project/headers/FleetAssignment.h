@@ -0,0 +1,57 @@
+#ifndef FLEET_ASSIGNMENT_H
+#define FLEET_ASSIGNMENT_H
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+#include <cstddef>
+#include "Airplane.h"
+#include "Destination.h"
+#include "RouteCostEngine.h"
+#include "SlotMap.h"
+
+using namespace std;
+
+struct FleetAssignment {
+    vector<RouteAssignment> routes;
+    size_t assignedRoutes;
+    double totalCost;
+};
+
+// Разпределя самолетите по маршрути така, че всеки самолет да изпълнява
+// най-много един маршрут, да се покрият възможно най-много маршрути и
+// общата цена да е минимална. Допустимостта и цената зависят от класа и от
+// разстоянието от базата до дестинацията, затова задачата се решава като
+// поток с минимална цена между маршрути и групи самолети от един клас с
+// обща база, а не между маршрути и отделни самолети.
+class FleetAssignmentOptimizer {
+private:
+    struct AirplaneGroup {
+        Airplane representative;
+        uint32_t baseAirport;
+        vector<SlotHandle<Airplane> > members;
+    };
+
+    vector<AirplaneGroup> groups_;
+    vector<string> baseAirportCodes_;
+    unordered_map<string, uint32_t> baseAirportIds_;
+    size_t classCount_;
+
+public:
+    FleetAssignmentOptimizer(const vector<Airplane>& airplanes,
+                             const vector<SlotHandle<Airplane> >& handles);
+
+    size_t getClassCount() const;
+    size_t getGroupCount() const;
+    // Базите на изправните самолети, номерирани по реда на първата поява.
+    const vector<string>& getBaseAirportCodes() const;
+
+    // baseDistances[route * getBaseAirportCodes().size() + b] е разстоянието
+    // от база b до дестинацията на маршрута.
+    FleetAssignment assign(const vector<const Destination*>& destinations,
+                           const vector<RouteRequest>& routes,
+                           const vector<double>& baseDistances) const;
+};
+
+#endif
@@ -0,0 +1,65 @@
+#ifndef FLEET_CHANGE_QUEUE_H
+#define FLEET_CHANGE_QUEUE_H
+
+#include <vector>
+#include <string>
+#include <atomic>
+#include <cstddef>
+
+using namespace std;
+
+enum FleetChangeType {
+    PLANE_CLASS_ADDED,
+    PLANE_CLASS_UPDATED,
+    AIRPLANE_ADDED,
+    AIRPLANE_REMOVED,
+    AIRPLANE_OPERATIONAL_CHANGED,
+    AIRPLANE_HOURS_ADDED,
+    AIRPLANE_BASE_CHANGED,
+    DESTINATION_ADDED,
+    DESTINATION_REMOVED,
+    DESTINATION_RUNWAY_CHANGED,
+    // Всички данни са изчистени; по-ранните събития вече не са в сила.
+    FLEET_CLEARED
+};
+
+// key е идентификаторът на класа, номерът на самолета или кодът на
+// дестинацията; при FLEET_CLEARED е празен.
+struct FleetChange {
+    FleetChangeType type;
+    string key;
+};
+
+// Ограничена опашка без заключване с един производител и един потребител.
+// Производителят е FleetManager, който пише само под своята ключалка;
+// потребителят е една нишка, която прибира събитията на партиди. Ако
+// потребителят изостане и опашката се напълни, новите събития се изпускат
+// и се вдига флаг, след който потребителят трябва да пресметне всичко наново.
+class FleetChangeQueue {
+private:
+    vector<FleetChange> slots_;
+    size_t mask_;
+    alignas(64) atomic<size_t> head_;
+    alignas(64) atomic<size_t> tail_;
+    alignas(64) atomic<bool> overflowed_;
+
+public:
+    // Капацитетът се закръгля нагоре до степен на двойката.
+    explicit FleetChangeQueue(size_t capacity);
+    FleetChangeQueue(const FleetChangeQueue&) = delete;
+    FleetChangeQueue& operator=(const FleetChangeQueue&) = delete;
+
+    size_t capacity() const;
+    size_t size() const;
+
+    // Добавя партидата с едно публикуване, така че потребителят не вижда
+    // началото ѝ преди края. Връща колко събития са влезли; останалите се
+    // изпускат.
+    size_t push(const vector<FleetChange>& changes);
+    // Премества до maxCount събития в края на changes и връща броя им.
+    size_t poll(vector<FleetChange>& changes, size_t maxCount);
+    // Връща дали е имало изпуснати събития от последното извикване насам.
+    bool takeOverflow();
+};
+
+#endif
@@ -0,0 +1,65 @@
+#ifndef FLEET_CSV_H
+#define FLEET_CSV_H
+
+#include <istream>
+#include <ostream>
+#include <string>
+#include <vector>
+#include <cstddef>
+#include "FleetManager.h"
+#include "CsvWriter.h"
+
+using namespace std;
+
+struct ImportSummary {
+    size_t imported;
+    size_t duplicates;
+    size_t rejected;
+};
+
+// Масов импорт и експорт на флота във формат CSV/TSV. Импортът чете потока
+// запис по запис, добавя валидните редове на партиди и записва отхвърлените
+// редове заедно с причината във отделен файл.
+class FleetCsv {
+public:
+    static const size_t DEFAULT_BATCH_SIZE = 4096;
+
+    static ImportSummary importPlaneClasses(FleetManager& manager, istream& input, char delimiter,
+                                            ostream* rejects,
+                                            size_t batchSize = DEFAULT_BATCH_SIZE);
+    static ImportSummary importAirplanes(FleetManager& manager, istream& input, char delimiter,
+                                         ostream* rejects, size_t batchSize = DEFAULT_BATCH_SIZE);
+    static ImportSummary importDestinations(FleetManager& manager, istream& input,
+                                            char delimiter, ostream* rejects,
+                                            size_t batchSize = DEFAULT_BATCH_SIZE);
+    static bool importFile(FleetManager& manager, const string& kind, const string& filename,
+                           const string& rejectsFilename, ImportSummary& summary);
+
+    static void writePlaneClass(CsvWriter& writer, const PlaneClass& planeClass);
+    static void writeAirplane(CsvWriter& writer, const Airplane& airplane);
+    static void writeDestination(CsvWriter& writer, const Destination& destination);
+
+    static void exportPlaneClasses(const FleetManager& manager, ostream& output, char delimiter);
+    static void exportAirplanes(const FleetManager& manager, ostream& output, char delimiter);
+    static void exportAirplanes(const FleetManager& manager, const vector<AirplaneHandle>& handles,
+                                ostream& output, char delimiter);
+    static void exportDestinations(const FleetManager& manager, ostream& output, char delimiter);
+    static bool exportFile(const FleetManager& manager, const string& kind,
+                           const string& filename);
+    static bool exportCompatibleAirplanes(const FleetManager& manager, double runwayLength,
+                                          double distance, const string& filename);
+
+    static void writeRouteAssignment(CsvWriter& writer, const FleetManager& manager,
+                                     const RouteRequest& route,
+                                     const RouteAssignment& assignment);
+    static vector<RouteRequest> readRouteRequests(istream& input, char delimiter);
+    static bool planRoutesFile(const FleetManager& manager, const string& routesFilename,
+                               const string& resultFilename);
+    static bool assignRoutesFile(const FleetManager& manager, const string& routesFilename,
+                                 const string& resultFilename, FleetAssignment& assignment);
+
+private:
+    FleetCsv() = delete;
+};
+
+#endif
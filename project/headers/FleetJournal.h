@@ -0,0 +1,55 @@
+#ifndef FLEET_JOURNAL_H
+#define FLEET_JOURNAL_H
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <cstddef>
+
+using namespace std;
+
+// Журнал с добавяне в края: всяка промяна по флота е един ред с полета,
+// разделени с табулация. При зареждане редовете се прилагат отново върху
+// последно запазените данни. Първият ред казва върху кое поколение на
+// файловете с данни са записите, защото повторното им прилагане върху
+// следващо поколение би добавило часовете и превключило статусите втори път.
+// Записите на една транзакция са оградени с "#begin N" и "#commit", така че
+// при прекъсване по средата не се прилага само част от тях.
+class FleetJournal {
+private:
+    string filename_;
+    ofstream file_;
+    size_t recordCount_;
+    bool autoFlush_;
+    unsigned long generation_;
+
+    bool rewrite(const vector<string>& records);
+
+public:
+    explicit FleetJournal(const string& filename);
+    ~FleetJournal();
+
+    // Журнал от друго поколение вече е отразен в данните и се изчиства.
+    bool open(unsigned long generation);
+    bool append(const string& record);
+    // Записва всички записи като една партида и ги изпраща към диска наведнъж.
+    bool appendBatch(const vector<string>& records);
+    bool reset(unsigned long generation);
+    bool flush();
+    void setAutoFlush(bool autoFlush);
+
+    size_t getRecordCount() const;
+    const string& getFilename() const;
+    unsigned long getGeneration() const;
+
+    // Връща само завършените с нов ред записи; последен ред без него е
+    // прекъснат по средата и се пропуска, както и партида без "#commit".
+    // И в двата случая truncated става true. Журнал без заглавие е от
+    // поколение 0. lineNumbers получава номера на реда на всеки запис.
+    static bool readRecords(const string& filename, unsigned long& generation,
+                            vector<string>& records, vector<size_t>& lineNumbers,
+                            bool& truncated);
+    static vector<string> splitRecord(const string& record);
+};
+
+#endif
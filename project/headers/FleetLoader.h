@@ -0,0 +1,60 @@
+#ifndef FLEET_LOADER_H
+#define FLEET_LOADER_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstddef>
+#include "PlaneClass.h"
+#include "Destination.h"
+
+using namespace std;
+
+struct AirplaneRow {
+    string identificationNumber;
+    string planeClassId;
+    bool operational;
+    string baseAirportCode;
+    int totalFlightHours;
+    // За съобщението, ако FleetManager отхвърли реда.
+    size_t lineNumber;
+};
+
+struct LoadError {
+    string filename;
+    size_t lineNumber;
+    string reason;
+};
+
+struct LoadedFleetData {
+    bool planeClassesFound;
+    bool airplanesFound;
+    bool destinationsFound;
+    vector<PlaneClass> planeClasses;
+    vector<AirplaneRow> airplanes;
+    vector<Destination> destinations;
+    vector<LoadError> errors;
+};
+
+// Чете трите текстови файла едновременно, като големия файл със самолети
+// разделя на части по редове и ги обработва паралелно. Разрешаването на
+// класовете и премахването на дубликати остава за FleetManager.
+class FleetLoader {
+public:
+    static LoadedFleetData load(const string& planeClassesFile, const string& airplanesFile,
+                                const string& destinationsFile, unsigned threadCount);
+
+    static bool readWholeFile(const string& filename, string& contents);
+    static void parsePlaneClasses(const string& filename, string_view contents,
+                                  vector<PlaneClass>& planeClasses, vector<LoadError>& errors);
+    static size_t parseAirplanes(const string& filename, string_view contents, size_t begin,
+                                 size_t end, size_t firstLineNumber,
+                                 vector<AirplaneRow>& airplanes, vector<LoadError>& errors);
+    static void parseDestinations(const string& filename, string_view contents,
+                                  vector<Destination>& destinations, vector<LoadError>& errors);
+
+private:
+    FleetLoader() = delete;
+};
+
+#endif
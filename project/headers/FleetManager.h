@@ -3,29 +3,172 @@
 
 #include <vector>
 #include <string>
+#include <unordered_map>
+#include <memory>
+#include <atomic>
+#include <mutex>
 #include <iostream>
 #include <fstream>
+#include <functional>
 #include "Airplane.h"
 #include "Destination.h"
 #include "PlaneClass.h"
 #include "Validator.h"
+#include "SlotMap.h"
+#include "CompatibilityIndex.h"
+#include "CompatibilityMatrix.h"
+#include "PlaneClassRangeIndex.h"
+#include "FleetJournal.h"
+#include "FleetLoader.h"
+#include "FleetSnapshot.h"
+#include "EpochReclaimer.h"
+#include "RouteCostEngine.h"
+#include "FleetAssignment.h"
+#include "RoutePlanner.h"
+#include "GeoIndex.h"
+#include "DistanceCache.h"
+#include "FleetViews.h"
+#include "FleetChangeQueue.h"
+#include "FleetTransaction.h"
 
 using namespace std;
 
+typedef SlotHandle<Airplane> AirplaneHandle;
+typedef SlotHandle<Destination> DestinationHandle;
+typedef SlotHandle<shared_ptr<const PlaneClass> > PlaneClassHandle;
+
 class FleetManager {
 private:
-    vector<Airplane> airplanes_;
-    vector<Destination> destinations_;
-    vector<PlaneClass> planeClasses_;
+    SlotMap<Airplane> airplanes_;
+    SlotMap<Destination> destinations_;
+    // Записите за класовете не се променят: updatePlaneClass създава нов
+    // обект, затова версиите и копията на мениджъра ги споделят.
+    SlotMap<shared_ptr<const PlaneClass> > planeClasses_;
     string companyName_;
     string dataDirectory_;
+    unordered_map<string, AirplaneHandle> airplaneIndexById_;
+    unordered_map<string, DestinationHandle> destinationIndexByCode_;
+    unordered_map<string, PlaneClassHandle> planeClassIndexById_;
+    CompatibilityIndex compatibilityIndex_;
+    // Пренарежда се при първата заявка след промяна на класовете, а не при
+    // всяко добавяне, иначе зареждането на C класа би струвало O(C² log C).
+    mutable PlaneClassRangeIndex planeClassRangeIndex_;
+    mutable bool planeClassRangeIndexDirty_;
+    unordered_map<const PlaneClass*, vector<AirplaneHandle> > airplanesByClass_;
+    unique_ptr<FleetJournal> journal_;
+    size_t journalCompactionThreshold_;
+    int journalSuppressionDepth_;
+    int bulkUpdateDepth_;
+    vector<LoadError> lastLoadErrors_;
+    mutable recursive_mutex writeMutex_;
+    int writeDepth_;
+    mutable bool publishingEnabled_;
+    mutable bool snapshotDirty_;
+    mutable unsigned long snapshotVersion_;
+    mutable atomic<const FleetSnapshot*> currentSnapshot_;
+    mutable PersistentVector<Airplane> publishedAirplanes_;
+    mutable PersistentVector<Destination> publishedDestinations_;
+    mutable PersistentMap<string, uint32_t> publishedAirplanePositions_;
+    mutable PersistentMap<string, uint32_t> publishedDestinationPositions_;
+    mutable SnapshotCompatibility publishedCompatibility_;
+    // Строи се при първото планиране на полет и се изхвърля при промяна на
+    // дестинациите или класовете, заедно с кешираните графи.
+    mutable unique_ptr<RoutePlanner> routePlanner_;
+    mutable unique_ptr<GeoIndex> geoIndex_;
+    mutable DistanceCache distanceCache_;
+    // Както при публикуването: изгледите се строят при първата заявка към
+    // тях и оттогава се обновяват при всяка промяна.
+    mutable FleetViews views_;
+    mutable bool viewsEnabled_;
+    // Промените от текущата външна промяна; при излизане от нея се
+    // изпращат като една партида на всеки абонат.
+    vector<shared_ptr<FleetChangeQueue> > subscribers_;
+    vector<FleetChange> pendingChanges_;
+    // Докато тече транзакция, записите за журнала се трупат тук и се
+    // записват наведнъж при успех или се изхвърлят при отмяна.
+    bool capturingRecords_;
+    vector<string> capturedRecords_;
+
+    // Сериализира писателите; при излизане от най-външната промяна се
+    // публикува нова версия за читателите, ако има промени.
+    class WriteScope {
+    private:
+        FleetManager& manager_;
+
+    public:
+        explicit WriteScope(FleetManager& manager);
+        ~WriteScope();
+    };
+
+    void beginWrite();
+    void endWrite();
+    void enablePublishing() const;
+    void publishSnapshot() const;
+    FleetSnapshot* makeSnapshot(unsigned long version) const;
+
+    // Устойчивите копия на самолетите и дестинациите се поддържат само след
+    // като някой е поискал версия; дотогава промените не плащат за тях.
+    void rebuildPublishedState() const;
+    void fillPersistentState(PersistentVector<Airplane>& airplaneCopies,
+                             PersistentVector<Destination>& destinationCopies,
+                             PersistentMap<string, uint32_t>& airplanePositions,
+                             PersistentMap<string, uint32_t>& destinationPositions,
+                             SnapshotCompatibility& compatibility) const;
+    void clearPublishedState() const;
+    void publishAirplaneAt(size_t position);
+    void unpublishAirplane(const string& id, size_t position);
+    void publishDestinationAt(size_t position);
+    void unpublishDestination(const string& code, size_t position);
+
+    shared_ptr<const PlaneClass> findSharedPlaneClass(const string& classId) const;
+    bool insertAirplane(Airplane airplane, const shared_ptr<const PlaneClass>& registered);
+    vector<AirplaneHandle> getDenseAirplaneHandles() const;
+    vector<const Destination*> findRouteDestinations(const vector<RouteRequest>& routes) const;
+    // Разстоянията от всяка база в compatibilityIndex_ до дестинацията.
+    void computeBaseDistances(const Destination& destination, double* distances) const;
+    // Разстоянията от всяка от базите baseAirportCodes до дестинацията на
+    // всеки маршрут, ред по маршрут; редът на непозната дестинация е нулев.
+    vector<double> computeRouteBaseDistances(const vector<const Destination*>& destinations,
+                                             const vector<string>& baseAirportCodes) const;
 
-    bool saveAirplanesToFile(const string& filename) const;
-    bool loadAirplanesFromFile(const string& filename);
-    bool saveDestinationsToFile(const string& filename) const;
-    bool loadDestinationsFromFile(const string& filename);
-    bool savePlaneClassesToFile(const string& filename) const;
-    bool loadPlaneClassesFromFile(const string& filename);
+    void enableViews() const;
+    void addAirplaneToViews(AirplaneHandle handle) const;
+    void removeAirplaneFromViews(AirplaneHandle handle) const;
+    void addDestinationToViews(DestinationHandle handle) const;
+    void refreshAirplanesBasedAt(const string& code) const;
+
+    void notifyChange(FleetChangeType type, const string& key);
+    void flushChanges();
+    // Записите за журнала се форматират само ако наистина ще бъдат записани.
+    bool isJournaling() const;
+    void recordChange(FleetChangeType type, const string& key, const string& record);
+
+    bool validateTransaction(const FleetTransaction& transaction, TransactionResult& result) const;
+    bool applyOperation(const FleetTransaction& transaction,
+                        const FleetTransaction::Operation& operation,
+                        vector<function<void()> >& undo);
+    // Само за отмяна на клас, добавен от транзакцията, който още няма самолети.
+    void erasePlaneClass(const string& classId);
+    bool journalNeedsCompaction() const;
+    bool replayJournal(const string& filename, unsigned long generation);
+    bool applyJournalRecord(const vector<string>& fields);
+    static string formatPlaneClassRecord(const string& tag, const PlaneClass& planeClass);
+
+    bool saveAirplanesToFile(const string& filename, unsigned long generation) const;
+    bool saveDestinationsToFile(const string& filename, unsigned long generation) const;
+    bool savePlaneClassesToFile(const string& filename, unsigned long generation) const;
+    // Прочетените редове се преместват във флота, а не се копират; редовете
+    // със самолети, които не могат да бъдат добавени, отиват в data.errors.
+    void mergeLoadedData(LoadedFleetData& data, const string& airplanesFile);
+    bool loadFromFiles();
+    // Поема данните на зареден временен флот; кешовете се строят наново.
+    void adoptFleetData(FleetManager& loaded);
+
+    vector<string> getDataFilePaths() const;
+    unsigned long readCommittedGeneration() const;
+    static unsigned long readFileGeneration(const string& filename);
+    static unsigned long readSnapshotGeneration(const string& filename);
+    bool recoverInterruptedSave(unsigned long committedGeneration) const;
 
 public:
     FleetManager();
@@ -33,40 +176,134 @@ public:
     FleetManager(const FleetManager& other);
     ~FleetManager();
 
+    // Достъп до последната публикувана версия. Докато обектът е жив,
+    // версията не се освобождава; четенето не заключва и не чака писателя.
+    class SnapshotReader {
+    private:
+        EpochReclaimer::Guard guard_;
+        const FleetSnapshot* snapshot_;
+
+    public:
+        explicit SnapshotReader(const atomic<const FleetSnapshot*>& current);
+        SnapshotReader(const SnapshotReader&) = delete;
+        SnapshotReader& operator=(const SnapshotReader&) = delete;
+
+        const FleetSnapshot& operator*() const;
+        const FleetSnapshot* operator->() const;
+    };
+
     string getCompanyName() const;
     string getDataDirectory() const;
+    string getSnapshotFilePath() const;
     size_t getAirplaneCount() const;
+    size_t getOperationalAirplaneCount() const;
     size_t getDestinationCount() const;
     size_t getPlaneClassCount() const;
     const vector<Airplane>& getAirplanes() const;
     const vector<Destination>& getDestinations() const;
-    const vector<PlaneClass>& getPlaneClasses() const;
+    const vector<shared_ptr<const PlaneClass> >& getPlaneClasses() const;
+    // Първото извикване включва непрекъснатото публикуване на версии.
+    SnapshotReader readSnapshot() const;
+    // Копие на текущото състояние. Само по себе си не включва публикуването,
+    // затова извеждането и записването не оскъпяват следващите промени.
+    shared_ptr<const FleetSnapshot> takeSnapshot() const;
 
     void setCompanyName(const string& name);
     void setDataDirectory(const string& directory);
 
     bool addPlaneClass(const PlaneClass& planeClass);
     bool addAirplane(const Airplane& airplane);
+    bool addAirplane(Airplane&& airplane);
     bool addDestination(const Destination& destination);
+    bool addDestination(Destination&& destination);
+
+    // Създават обекта на място от аргументите на конструктора му.
+    template <typename... Args>
+    bool emplaceAirplane(Args&&... args) {
+        return addAirplane(Airplane(forward<Args>(args)...));
+    }
+
+    template <typename... Args>
+    bool emplaceDestination(Args&&... args) {
+        return addDestination(Destination(forward<Args>(args)...));
+    }
+
+    size_t addPlaneClasses(const vector<PlaneClass>& planeClasses);
+    size_t addAirplanes(const vector<Airplane>& airplanes);
+    size_t addDestinations(const vector<Destination>& destinations);
+    void beginBulkUpdate();
+    void endBulkUpdate();
     bool removeAirplaneById(const string& id);
     bool removeDestinationByCode(const string& code);
+    bool updatePlaneClass(const PlaneClass& planeClass);
+    bool setAirplaneOperational(const string& id, bool operational);
+    bool setAirplaneBase(const string& id, const string& baseAirportCode);
+    bool setDestinationRunwayLength(const string& code, double length);
+    bool addAirplaneFlightHours(const string& id, int hours);
+    TransactionResult commitTransaction(const FleetTransaction& transaction);
+
+    // Обектите се дават само за четене: индексите, изгледите, журналът и
+    // публикуваните версии следят промените само през методите по-горе.
+    const Airplane* findAirplaneById(const string& id) const;
+    const Destination* findDestinationByCode(const string& code) const;
+    const PlaneClass* findPlaneClassById(const string& classId) const;
+
+    AirplaneHandle findAirplaneHandleById(const string& id) const;
+    DestinationHandle findDestinationHandleByCode(const string& code) const;
+    PlaneClassHandle findPlaneClassHandleById(const string& classId) const;
+    const Airplane* getAirplane(AirplaneHandle handle) const;
+    const Destination* getDestination(DestinationHandle handle) const;
+    const PlaneClass* getPlaneClass(PlaneClassHandle handle) const;
+    shared_ptr<const PlaneClass> getSharedPlaneClass(PlaneClassHandle handle) const;
 
-    Airplane* findAirplaneById(const string& id);
-    Destination* findDestinationByCode(const string& code);
-    PlaneClass* findPlaneClassById(const string& classId);
+    vector<const Airplane*> findAirplanesForDestination(const string& destinationCode) const;
+    vector<const Airplane*> findCompatibleAirplanes(double runwayLength, double distance) const;
+    vector<const Airplane*> getOperationalAirplanes() const;
 
-    vector<Airplane*> findAirplanesForDestination(const string& destinationCode);
-    vector<Airplane*> findCompatibleAirplanes(double runwayLength, double distance);
-    vector<Airplane*> getOperationalAirplanes();
+    vector<AirplaneHandle> findAirplaneHandlesForDestination(const string& destinationCode) const;
+    // Дестинациите на не повече от radiusKm от летището code, по
+    // нарастващо разстояние; самото летище не се включва.
+    vector<DestinationHandle> findDestinationHandlesWithinKm(const string& code,
+                                                             double radiusKm) const;
+    vector<AirplaneHandle> findCompatibleAirplaneHandles(double runwayLength, double distance) const;
+    vector<AirplaneHandle> getOperationalAirplaneHandles() const;
+
+    CompatibilityMatrix buildCompatibilityMatrix(unsigned threadCount = 0) const;
+
+    vector<PlaneClassHandle> findCompatiblePlaneClasses(double runwayLength, double distance) const;
+    vector<AirplaneHandle> findOperationalAirplanesByClass(double runwayLength, double distance) const;
+
+    RouteCostEngine buildRouteCostEngine() const;
+    vector<RouteAssignment> planRoutes(const vector<RouteRequest>& routes,
+                                       unsigned threadCount = 0) const;
+    FleetAssignment assignFleet(const vector<RouteRequest>& routes) const;
+    FlightPlan planFlight(const string& classId, const string& originCode,
+                          const string& targetCode, RoutingObjective objective) const;
 
     void displayAllAirplanes(ostream& os) const;
     void displayAllDestinations(ostream& os) const;
     void displayAllPlaneClasses(ostream& os) const;
 
     bool saveAllData() const;
+    // Заменя текущите данни със записаните; при неуспех флотът не се променя.
     bool loadAllData();
+    const vector<LoadError>& getLastLoadErrors() const;
+    void displayLoadErrors(ostream& os) const;
+    bool saveSnapshot(const string& filename) const;
+    bool loadSnapshot(const string& filename);
+
+    string getJournalFilePath() const;
+    bool enableJournal(size_t compactionThreshold);
+    void disableJournal();
+    bool discardJournal();
+    bool isJournalEnabled() const;
     void clearAllData();
 
+    // Абонатът получава промените на партиди, по една за всяка завършена
+    // външна промяна. Опашката се чете от една нишка без заключване.
+    shared_ptr<FleetChangeQueue> subscribe(size_t capacity);
+    void unsubscribe(const shared_ptr<FleetChangeQueue>& queue);
+
     friend ostream& operator<<(ostream& os, const FleetManager& manager);
 
     static void displayMainMenu();
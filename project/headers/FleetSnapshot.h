@@ -0,0 +1,64 @@
+#ifndef FLEET_SNAPSHOT_H
+#define FLEET_SNAPSHOT_H
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <iostream>
+#include <cstdint>
+#include "Airplane.h"
+#include "Destination.h"
+#include "PlaneClass.h"
+#include "PersistentVector.h"
+#include "PersistentMap.h"
+#include "SnapshotCompatibility.h"
+
+using namespace std;
+
+// Неизменима версия на флота, публикувана от FleetManager. Самолетите и
+// дестинациите са в устойчиви структури, които споделят непроменените си
+// възли с предишните версии, затова създаването и копирането на версия
+// струва O(брой класове), а не O(размер на флота). Класовете се споделят с
+// FleetManager, който при редакция създава нов обект вместо да променя
+// публикувания. Заявките за съвместимост обхождат само компактните записи
+// в SnapshotCompatibility, а не самите самолети.
+class FleetSnapshot {
+private:
+    unsigned long version_;
+    string companyName_;
+    PersistentVector<Airplane> airplanes_;
+    PersistentVector<Destination> destinations_;
+    vector<shared_ptr<const PlaneClass> > planeClasses_;
+    PersistentMap<string, uint32_t> airplanePositionById_;
+    PersistentMap<string, uint32_t> destinationPositionByCode_;
+    SnapshotCompatibility compatibility_;
+
+public:
+    FleetSnapshot(unsigned long version, const string& companyName,
+                  const PersistentVector<Airplane>& airplanes,
+                  const PersistentVector<Destination>& destinations,
+                  const vector<shared_ptr<const PlaneClass> >& planeClasses,
+                  const PersistentMap<string, uint32_t>& airplanePositionById,
+                  const PersistentMap<string, uint32_t>& destinationPositionByCode,
+                  const SnapshotCompatibility& compatibility);
+
+    unsigned long getVersion() const;
+    const string& getCompanyName() const;
+    const PersistentVector<Airplane>& getAirplanes() const;
+    const PersistentVector<Destination>& getDestinations() const;
+    const vector<shared_ptr<const PlaneClass> >& getPlaneClasses() const;
+
+    const Airplane* findAirplaneById(const string& id) const;
+    const Destination* findDestinationByCode(const string& code) const;
+    vector<const Airplane*> findCompatibleAirplanes(double runwayLength, double distance) const;
+    vector<const Airplane*> findAirplanesForDestination(const string& destinationCode) const;
+    vector<const Airplane*> getOperationalAirplanes() const;
+
+    void displayAllAirplanes(ostream& os) const;
+    void displayAllDestinations(ostream& os) const;
+    void displayAllPlaneClasses(ostream& os) const;
+
+    bool saveBinary(const string& filename, unsigned long generation = 0) const;
+};
+
+#endif
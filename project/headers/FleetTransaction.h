@@ -0,0 +1,92 @@
+#ifndef FLEET_TRANSACTION_H
+#define FLEET_TRANSACTION_H
+
+#include <string>
+#include <vector>
+#include <cstddef>
+#include "Airplane.h"
+#include "Destination.h"
+#include "PlaneClass.h"
+
+using namespace std;
+
+enum TransactionStatus {
+    TRANSACTION_COMMITTED,
+    // Проверката е отхвърлила операция; флотът не е променян.
+    TRANSACTION_REJECTED,
+    // Операция се е провалила при прилагането; приложените дотогава са отменени.
+    TRANSACTION_ROLLED_BACK
+};
+
+struct TransactionResult {
+    TransactionStatus status;
+    // Номерът на провалилата се операция; при успех е броят на операциите.
+    size_t failedOperation;
+    string message;
+};
+
+// Поредица от промени по флота, които FleetManager::commitTransaction
+// проверява заедно и прилага наведнъж: читателите и абонатите виждат
+// или всички, или нито една, а в журнала те влизат като една партида.
+// Самата транзакция само събира операциите и не знае нищо за флота.
+class FleetTransaction {
+public:
+    enum OperationType {
+        ADD_PLANE_CLASS,
+        UPDATE_PLANE_CLASS,
+        ADD_AIRPLANE,
+        REMOVE_AIRPLANE,
+        SET_AIRPLANE_OPERATIONAL,
+        ADD_AIRPLANE_FLIGHT_HOURS,
+        SET_AIRPLANE_BASE,
+        ADD_DESTINATION,
+        REMOVE_DESTINATION,
+        SET_DESTINATION_RUNWAY
+    };
+
+    // key е идентификаторът на класа, номерът на самолета или кодът на
+    // дестинацията. Добавените и променените обекти са в отделни списъци,
+    // а item е позицията в съответния списък.
+    struct Operation {
+        OperationType type;
+        string key;
+        string text;
+        bool flag;
+        double value;
+        size_t item;
+    };
+
+private:
+    vector<Operation> operations_;
+    vector<PlaneClass> planeClasses_;
+    vector<Airplane> airplanes_;
+    vector<Destination> destinations_;
+
+    void stage(OperationType type, const string& key, const string& text, bool flag,
+               double value, size_t item);
+
+public:
+    FleetTransaction();
+
+    void addPlaneClass(const PlaneClass& planeClass);
+    void updatePlaneClass(const PlaneClass& planeClass);
+    void addAirplane(const Airplane& airplane);
+    void removeAirplane(const string& id);
+    void setAirplaneOperational(const string& id, bool operational);
+    void addAirplaneFlightHours(const string& id, int hours);
+    void setAirplaneBase(const string& id, const string& baseAirportCode);
+    void addDestination(const Destination& destination);
+    void removeDestination(const string& code);
+    void setDestinationRunwayLength(const string& code, double length);
+
+    size_t size() const;
+    bool empty() const;
+    void clear();
+
+    const vector<Operation>& getOperations() const;
+    const PlaneClass& getPlaneClass(size_t item) const;
+    const Airplane& getAirplane(size_t item) const;
+    const Destination& getDestination(size_t item) const;
+};
+
+#endif
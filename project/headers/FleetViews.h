@@ -0,0 +1,56 @@
+#ifndef FLEET_VIEWS_H
+#define FLEET_VIEWS_H
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include "Airplane.h"
+#include "Destination.h"
+#include "SlotMap.h"
+
+using namespace std;
+
+// Поддържани наготово отговори на две чести заявки: кои самолети са
+// оперативни и кои самолети могат да летят до всяка дестинация. Всяка
+// съвместима двойка е връзка, записана и в списъка на дестинацията, и в
+// списъка на самолета, заедно с позициите си в тях, така че добавянето и
+// премахването на връзка са O(1), а на самолет или дестинация - O(броя на
+// връзките му). Кои двойки са съвместими решава FleetManager.
+class FleetViews {
+private:
+    struct Link {
+        SlotHandle<Destination> destination;
+        SlotHandle<Airplane> airplane;
+        uint32_t destinationPosition;
+        uint32_t airplanePosition;
+    };
+
+    vector<SlotHandle<Airplane> > operational_;
+    // Позицията в operational_ по индекс на слота на самолета.
+    vector<uint32_t> operationalPositions_;
+    vector<Link> links_;
+    vector<uint32_t> freeLinks_;
+    vector<vector<uint32_t> > linksByDestination_;
+    vector<vector<uint32_t> > linksByAirplane_;
+
+    void detachFromDestination(uint32_t link);
+    void detachFromAirplane(uint32_t link);
+
+public:
+    FleetViews();
+
+    size_t getLinkCount() const;
+    void clear();
+
+    void setOperational(SlotHandle<Airplane> airplane, bool operational);
+    void link(SlotHandle<Destination> destination, SlotHandle<Airplane> airplane);
+    void unlinkAirplane(SlotHandle<Airplane> airplane);
+    void unlinkDestination(SlotHandle<Destination> destination);
+
+    const vector<SlotHandle<Airplane> >& getOperationalAirplanes() const;
+    vector<SlotHandle<Airplane> > getAirplanesForDestination(
+        SlotHandle<Destination> destination) const;
+    size_t countAirplanesForDestination(SlotHandle<Destination> destination) const;
+};
+
+#endif
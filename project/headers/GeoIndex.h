@@ -0,0 +1,44 @@
+#ifndef GEO_INDEX_H
+#define GEO_INDEX_H
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include "Destination.h"
+
+using namespace std;
+
+// k-d дърво над дестинациите с координати. Точките са единични вектори в
+// три измерения: хордата между тях расте заедно с разстоянието по голям
+// кръг, така че търсенето в радиус е търсене в сфера без тригонометрия във
+// възлите и без особености при полюсите и 180-ия меридиан. Позициите
+// съвпадат с индексите във вектора, от който е построено дървото.
+class GeoIndex {
+private:
+    struct Point {
+        double coordinates[3];
+        uint32_t position;
+        uint8_t splitAxis;
+    };
+
+    // Дървото е неявно: коренът на [first, last) е средният елемент.
+    vector<Point> points_;
+
+    void build(size_t first, size_t last);
+    void collect(size_t first, size_t last, const double* center, double maxChordSquared,
+                 vector<uint32_t>& positions) const;
+
+public:
+    GeoIndex();
+    explicit GeoIndex(const vector<Destination>& destinations);
+
+    size_t size() const;
+
+    // Добавя позициите на дестинациите на не повече от radiusKm от center,
+    // което трябва да има координати. Заради закръгляне може да се върне и
+    // точка на границата, затова точното условие се проверява от извикващия.
+    void findWithinKm(const Destination& center, double radiusKm,
+                      vector<uint32_t>& positions) const;
+};
+
+#endif
@@ -0,0 +1,58 @@
+#ifndef MAPPED_FLEET_H
+#define MAPPED_FLEET_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include "BinarySnapshot.h"
+
+using namespace std;
+
+// Режим само за четене: двоичната моментна снимка от директорията с данни
+// се проектира в паметта с mmap и заявките работят директно върху записите,
+// без да се създават обекти и низове. Няколко процеса споделят едно и също
+// копие в page cache.
+class MappedFleet {
+private:
+    const char* data_;
+    size_t size_;
+    const SnapshotHeader* header_;
+    const SnapshotPlaneClass* planeClasses_;
+    const SnapshotAirplane* airplanes_;
+    const SnapshotDestination* destinations_;
+    vector<uint32_t> airplaneOrderById_;
+    vector<uint32_t> destinationOrderByCode_;
+
+    void buildLookupOrders();
+
+public:
+    MappedFleet();
+    ~MappedFleet();
+    MappedFleet(const MappedFleet&) = delete;
+    MappedFleet& operator=(const MappedFleet&) = delete;
+
+    bool open(const string& dataDirectory);
+    bool openFile(const string& filename);
+    void close();
+    bool isOpen() const;
+
+    string_view getCompanyName() const;
+    size_t getPlaneClassCount() const;
+    size_t getAirplaneCount() const;
+    size_t getDestinationCount() const;
+    const SnapshotPlaneClass& getPlaneClass(size_t index) const;
+    const SnapshotAirplane& getAirplane(size_t index) const;
+    const SnapshotDestination& getDestination(size_t index) const;
+    string_view getString(const SnapshotString& value) const;
+
+    const SnapshotAirplane* findAirplaneById(string_view id) const;
+    const SnapshotDestination* findDestinationByCode(string_view code) const;
+    void findCompatibleAirplanes(double runwayLength, double distance,
+                                 vector<uint32_t>& airplaneIndices) const;
+    void findAirplanesForDestination(string_view destinationCode,
+                                     vector<uint32_t>& airplaneIndices) const;
+};
+
+#endif
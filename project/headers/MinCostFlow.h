@@ -0,0 +1,49 @@
+#ifndef MIN_COST_FLOW_H
+#define MIN_COST_FLOW_H
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+using namespace std;
+
+// Поток с минимална цена, който се увеличава с по една единица от зададен
+// връх (както в унгарския алгоритъм за разредени графи). Пътят се търси с
+// алгоритъма на Дейкстра върху намалените цени, а потенциалите се пазят
+// между отделните стъпки, затова цените на ребрата трябва да са
+// неотрицателни. Ребрата с остатъчен капацитет стоят в началото на списъка
+// на всеки връх, така че обратните ребра без поток не се обхождат.
+class MinCostFlow {
+private:
+    struct Edge {
+        uint32_t to;
+        uint32_t slot;
+        int32_t capacity;
+        int64_t cost;
+    };
+
+    vector<vector<Edge> > adjacency_;
+    vector<uint32_t> residualCounts_;
+    // Позиция (връх, индекс) на всяко ребро; правото ребро с номер e е в
+    // слот 2e, а обратното му - в слот 2e + 1.
+    vector<pair<uint32_t, uint32_t> > slotPositions_;
+    vector<int64_t> potential_;
+
+    Edge& edgeAt(uint32_t slot);
+    void moveEdge(uint32_t node, uint32_t from, uint32_t to);
+    void changeCapacity(uint32_t slot, int32_t delta);
+
+public:
+    explicit MinCostFlow(size_t nodeCount);
+
+    size_t getNodeCount() const;
+    size_t addEdge(size_t from, size_t to, int32_t capacity, int64_t cost);
+    int32_t getFlow(size_t edge) const;
+
+    // Пуска една единица поток от from към sink по най-евтиния остатъчен
+    // път и записва цената му в pathCost. Във from не трябва да влиза
+    // остатъчен капацитет, т.е. всеки източник се използва веднъж.
+    bool augment(size_t from, size_t sink, int64_t& pathCost);
+};
+
+#endif
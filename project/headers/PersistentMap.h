@@ -0,0 +1,206 @@
+#ifndef PERSISTENT_MAP_H
+#define PERSISTENT_MAP_H
+
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <utility>
+#include <functional>
+#include <cstddef>
+#include <cstdint>
+
+using namespace std;
+
+// Асоциативен масив със структурно споделяне (hash array mapped trie):
+// всяко ниво използва 5 бита от хеша на ключа, а разклоненията пазят само
+// заетите си деца чрез битова маска. Копирането е O(1); промяната копира
+// само пътя до засегнатия лист, ако той се споделя с друго копие.
+template <typename K, typename V, typename Hash = hash<K> >
+class PersistentMap {
+private:
+    static const unsigned BITS = 5;
+    static const unsigned MASK = (1u << BITS) - 1;
+
+    struct Node {
+        bool leaf;
+        uint32_t bitmap;
+        vector<shared_ptr<Node> > children;
+        size_t hash;
+        vector<pair<K, V> > entries;
+
+        Node() : leaf(false), bitmap(0), children(), hash(0), entries() {}
+    };
+
+    shared_ptr<Node> root_;
+    size_t size_;
+    Hash hasher_;
+
+    static Node* editable(shared_ptr<Node>& node) {
+        if (node.use_count() != 1) {
+            node = make_shared<Node>(*node);
+        } else {
+            atomic_thread_fence(memory_order_acquire);
+        }
+        return node.get();
+    }
+
+    static unsigned fragment(size_t hash, unsigned shift) {
+        return static_cast<unsigned>(hash >> shift) & MASK;
+    }
+
+    static size_t childPosition(uint32_t bitmap, uint32_t bit) {
+        return static_cast<size_t>(__builtin_popcount(bitmap & (bit - 1)));
+    }
+
+    static shared_ptr<Node> makeLeaf(size_t hash, const K& key, const V& value) {
+        shared_ptr<Node> leaf = make_shared<Node>();
+        leaf->leaf = true;
+        leaf->hash = hash;
+        leaf->entries.push_back(make_pair(key, value));
+        return leaf;
+    }
+
+    // Разклонение, което разделя два листа с различни хешове.
+    static shared_ptr<Node> makeBranch(const shared_ptr<Node>& first,
+                                       const shared_ptr<Node>& second, unsigned shift) {
+        shared_ptr<Node> branch = make_shared<Node>();
+        unsigned firstFragment = fragment(first->hash, shift);
+        unsigned secondFragment = fragment(second->hash, shift);
+        if (firstFragment == secondFragment) {
+            branch->bitmap = 1u << firstFragment;
+            branch->children.push_back(makeBranch(first, second, shift + BITS));
+        } else {
+            branch->bitmap = (1u << firstFragment) | (1u << secondFragment);
+            if (firstFragment < secondFragment) {
+                branch->children.push_back(first);
+                branch->children.push_back(second);
+            } else {
+                branch->children.push_back(second);
+                branch->children.push_back(first);
+            }
+        }
+        return branch;
+    }
+
+    // Връща true, ако е добавен нов ключ.
+    static bool setIn(shared_ptr<Node>& node, size_t hash, unsigned shift, const K& key,
+                      const V& value) {
+        if (node->leaf) {
+            if (node->hash != hash) {
+                node = makeBranch(node, makeLeaf(hash, key, value), shift);
+                return true;
+            }
+            Node* leaf = editable(node);
+            for (auto& entry : leaf->entries) {
+                if (entry.first == key) {
+                    entry.second = value;
+                    return false;
+                }
+            }
+            leaf->entries.push_back(make_pair(key, value));
+            return true;
+        }
+
+        uint32_t bit = 1u << fragment(hash, shift);
+        size_t position = childPosition(node->bitmap, bit);
+        Node* branch = editable(node);
+        if ((branch->bitmap & bit) == 0) {
+            branch->children.insert(branch->children.begin() + position,
+                                    makeLeaf(hash, key, value));
+            branch->bitmap |= bit;
+            return true;
+        }
+        return setIn(branch->children[position], hash, shift + BITS, key, value);
+    }
+
+    // Ключът трябва да съществува. Празен възел се изтрива от родителя, а
+    // разклонение с едно-единствено дете лист се заменя с него.
+    static void eraseIn(shared_ptr<Node>& node, size_t hash, unsigned shift, const K& key) {
+        if (node->leaf) {
+            if (node->entries.size() == 1) {
+                node.reset();
+                return;
+            }
+            Node* leaf = editable(node);
+            for (size_t i = 0; i < leaf->entries.size(); ++i) {
+                if (leaf->entries[i].first == key) {
+                    leaf->entries.erase(leaf->entries.begin() + i);
+                    return;
+                }
+            }
+            return;
+        }
+
+        uint32_t bit = 1u << fragment(hash, shift);
+        size_t position = childPosition(node->bitmap, bit);
+        Node* branch = editable(node);
+        eraseIn(branch->children[position], hash, shift + BITS, key);
+        if (!branch->children[position]) {
+            branch->children.erase(branch->children.begin() + position);
+            branch->bitmap &= ~bit;
+        }
+        if (branch->children.empty()) {
+            node.reset();
+        } else if (branch->children.size() == 1 && branch->children[0]->leaf) {
+            shared_ptr<Node> onlyChild = branch->children[0];
+            node = onlyChild;
+        }
+    }
+
+public:
+    PersistentMap() : root_(), size_(0), hasher_() {}
+
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+
+    const V* find(const K& key) const {
+        size_t hash = hasher_(key);
+        const Node* node = root_.get();
+        unsigned shift = 0;
+        while (node && !node->leaf) {
+            uint32_t bit = 1u << fragment(hash, shift);
+            if ((node->bitmap & bit) == 0) {
+                return nullptr;
+            }
+            node = node->children[childPosition(node->bitmap, bit)].get();
+            shift += BITS;
+        }
+        if (!node || node->hash != hash) {
+            return nullptr;
+        }
+        for (const auto& entry : node->entries) {
+            if (entry.first == key) {
+                return &entry.second;
+            }
+        }
+        return nullptr;
+    }
+
+    void set(const K& key, const V& value) {
+        size_t hash = hasher_(key);
+        if (!root_) {
+            root_ = makeLeaf(hash, key, value);
+            size_ = 1;
+            return;
+        }
+        if (setIn(root_, hash, 0, key, value)) {
+            ++size_;
+        }
+    }
+
+    bool erase(const K& key) {
+        if (!find(key)) {
+            return false;
+        }
+        eraseIn(root_, hasher_(key), 0, key);
+        --size_;
+        return true;
+    }
+
+    void clear() {
+        root_.reset();
+        size_ = 0;
+    }
+};
+
+#endif
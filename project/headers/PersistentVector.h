@@ -0,0 +1,167 @@
+#ifndef PERSISTENT_VECTOR_H
+#define PERSISTENT_VECTOR_H
+
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <iterator>
+#include <cstddef>
+
+using namespace std;
+
+// Вектор със структурно споделяне: 32-разклонено дърво, чиито възли се
+// споделят между копията. Копирането е O(1); промяна по копие, чиито възли
+// се държат и от друго копие, копира само пътя от корена до листото.
+template <typename T>
+class PersistentVector {
+private:
+    static const size_t BITS = 5;
+    static const size_t WIDTH = size_t(1) << BITS;
+    static const size_t MASK = WIDTH - 1;
+
+    struct Node {
+        vector<shared_ptr<Node> > children;
+        vector<T> values;
+    };
+
+    shared_ptr<Node> root_;
+    size_t shift_;
+    size_t size_;
+
+    // Възел, държан само от това копие, се променя на място. Иначе се
+    // заменя със собствено копие. Оградата гарантира, че всички четения от
+    // копия, които вече са освободили възела, са завършили преди промяната.
+    static Node* editable(shared_ptr<Node>& node) {
+        if (node.use_count() != 1) {
+            node = make_shared<Node>(*node);
+        } else {
+            atomic_thread_fence(memory_order_acquire);
+        }
+        return node.get();
+    }
+
+    const Node* leafFor(size_t index) const {
+        const Node* node = root_.get();
+        for (size_t shift = shift_; shift > 0; shift -= BITS) {
+            node = node->children[(index >> shift) & MASK].get();
+        }
+        return node;
+    }
+
+    Node* editableLeafFor(size_t index) {
+        Node* node = editable(root_);
+        for (size_t shift = shift_; shift > 0; shift -= BITS) {
+            node = editable(node->children[(index >> shift) & MASK]);
+        }
+        return node;
+    }
+
+    size_t capacity() const { return root_ ? WIDTH << shift_ : 0; }
+
+    static bool popFrom(shared_ptr<Node>& node, size_t shift, size_t index) {
+        Node* editableNode = editable(node);
+        if (shift == 0) {
+            editableNode->values.pop_back();
+            return editableNode->values.empty();
+        }
+        if (popFrom(editableNode->children[(index >> shift) & MASK], shift - BITS, index)) {
+            editableNode->children.pop_back();
+        }
+        return editableNode->children.empty();
+    }
+
+public:
+    class const_iterator {
+    private:
+        const PersistentVector* owner_;
+        size_t index_;
+        const T* leafValues_;
+
+    public:
+        typedef forward_iterator_tag iterator_category;
+        typedef T value_type;
+        typedef ptrdiff_t difference_type;
+        typedef const T* pointer;
+        typedef const T& reference;
+
+        const_iterator(const PersistentVector* owner, size_t index)
+            : owner_(owner), index_(index), leafValues_(nullptr) {
+            if (index_ < owner_->size_) {
+                leafValues_ = owner_->leafFor(index_)->values.data();
+            }
+        }
+
+        reference operator*() const { return leafValues_[index_ & MASK]; }
+        pointer operator->() const { return &leafValues_[index_ & MASK]; }
+
+        const_iterator& operator++() {
+            ++index_;
+            if ((index_ & MASK) == 0 && index_ < owner_->size_) {
+                leafValues_ = owner_->leafFor(index_)->values.data();
+            }
+            return *this;
+        }
+
+        bool operator==(const const_iterator& other) const { return index_ == other.index_; }
+        bool operator!=(const const_iterator& other) const { return index_ != other.index_; }
+    };
+
+    PersistentVector() : root_(), shift_(0), size_(0) {}
+
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+
+    const T& operator[](size_t index) const { return leafFor(index)->values[index & MASK]; }
+
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, size_); }
+
+    void set(size_t index, const T& value) { editableLeafFor(index)->values[index & MASK] = value; }
+
+    void push_back(const T& value) {
+        if (size_ == capacity()) {
+            if (!root_) {
+                root_ = make_shared<Node>();
+                shift_ = 0;
+            } else {
+                shared_ptr<Node> newRoot = make_shared<Node>();
+                newRoot->children.push_back(root_);
+                root_ = newRoot;
+                shift_ += BITS;
+            }
+        }
+
+        Node* node = editable(root_);
+        for (size_t shift = shift_; shift > 0; shift -= BITS) {
+            size_t slot = (size_ >> shift) & MASK;
+            if (slot == node->children.size()) {
+                node->children.push_back(make_shared<Node>());
+            }
+            node = editable(node->children[slot]);
+        }
+        node->values.push_back(value);
+        ++size_;
+    }
+
+    void pop_back() {
+        popFrom(root_, shift_, size_ - 1);
+        --size_;
+        if (size_ == 0) {
+            clear();
+            return;
+        }
+        while (shift_ > 0 && root_->children.size() == 1) {
+            shared_ptr<Node> onlyChild = root_->children[0];
+            root_ = onlyChild;
+            shift_ -= BITS;
+        }
+    }
+
+    void clear() {
+        root_.reset();
+        shift_ = 0;
+        size_ = 0;
+    }
+};
+
+#endif
@@ -11,6 +11,9 @@ class PlaneClass {
 private:
     string manufacturer_;
     string model_;
+    // manufacturer_ + " " + model_; пази се готов, защото по него се търси
+    // при всяко сравнение на клас.
+    string classId_;
     int seatCount_;
     double minRunwayLength_;
     double fuelConsumptionPerKmPerSeat_;
@@ -24,8 +27,12 @@ public:
                int seatCount, double minRunwayLength, double fuelConsumption,
                double tankVolume, double avgSpeed, int crewCount);
     PlaneClass(const PlaneClass& other);
+    PlaneClass(PlaneClass&& other) noexcept;
     ~PlaneClass();
 
+    PlaneClass& operator=(const PlaneClass& other);
+    PlaneClass& operator=(PlaneClass&& other) noexcept;
+
     string getManufacturer() const;
     string getModel() const;
     int getSeatCount() const;
@@ -45,6 +52,7 @@ public:
     void setRequiredCrewCount(int count);
 
     string getClassId() const;
+    const string& getClassIdRef() const;
     double calculateMaxRange() const;
     double calculateFlightDuration(double distanceKm) const;
     double calculateFuelConsumption(double distanceKm, int passengers) const;
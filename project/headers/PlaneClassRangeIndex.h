@@ -0,0 +1,38 @@
+#ifndef PLANE_CLASS_RANGE_INDEX_H
+#define PLANE_CLASS_RANGE_INDEX_H
+
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include <cstddef>
+#include "PlaneClass.h"
+
+using namespace std;
+
+// Индекс за заявки "минимална писта <= дължина и обхват >= разстояние".
+// Класовете са сортирани по минимална писта; над тях е построено
+// сегментно дърво, чиито възли пазят класовете си сортирани по обхват.
+class PlaneClassRangeIndex {
+private:
+    struct Entry {
+        double maxRange;
+        uint32_t position;
+    };
+
+    vector<double> sortedMinRunwayLengths_;
+    size_t leafCount_;
+    vector<vector<Entry> > nodes_;
+
+    static void collectNode(const vector<Entry>& node, double distance,
+                            vector<uint32_t>& positions);
+
+public:
+    PlaneClassRangeIndex();
+
+    void rebuild(const vector<shared_ptr<const PlaneClass> >& planeClasses);
+    void clear();
+    void findCompatible(double runwayLength, double distance,
+                        vector<uint32_t>& positions) const;
+};
+
+#endif
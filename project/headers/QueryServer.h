@@ -0,0 +1,52 @@
+#ifndef QUERY_SERVER_H
+#define QUERY_SERVER_H
+
+#include <string>
+#include <vector>
+#include <cstddef>
+#include "FleetManager.h"
+#include "CommandInterpreter.h"
+
+using namespace std;
+
+// Сървър за заявки върху Unix domain socket. Флотът се зарежда веднъж, а
+// всички връзки се обслужват от един цикъл с poll(), така че заявките се
+// изпълняват последователно без заключване. Протоколът е същият като на
+// пакетния режим: ред с команда и отговор "ok"/"error".
+class QueryServer {
+private:
+    struct Connection {
+        int fd;
+        string input;
+        string output;
+        size_t outputOffset;
+        bool closing;
+    };
+
+    static const size_t MAX_REQUEST_BYTES = 64 * 1024;
+    static const size_t MAX_PENDING_OUTPUT_BYTES = 4 * 1024 * 1024;
+
+    CommandInterpreter interpreter_;
+    string socketPath_;
+    int listenFd_;
+    vector<Connection> connections_;
+
+    void acceptConnections();
+    bool readRequests(Connection& connection);
+    bool writeResponses(Connection& connection);
+    void closeConnection(size_t position);
+
+public:
+    QueryServer(FleetManager& manager, const string& socketPath);
+    ~QueryServer();
+    QueryServer(const QueryServer&) = delete;
+    QueryServer& operator=(const QueryServer&) = delete;
+
+    bool start();
+    void run();
+    void stop();
+
+    static void requestShutdown();
+};
+
+#endif
@@ -0,0 +1,31 @@
+#ifndef RECORD_READER_H
+#define RECORD_READER_H
+
+#include <string_view>
+#include <cstddef>
+
+using namespace std;
+
+// Обхожда редовете на буфер в паметта без копиране. Полетата се връщат
+// като string_view към самия буфер, а числата се разчитат на място.
+class RecordReader {
+private:
+    string_view contents_;
+    size_t position_;
+    size_t end_;
+    size_t lineNumber_;
+
+public:
+    RecordReader(string_view contents, size_t begin, size_t end, size_t firstLineNumber);
+
+    bool nextLine(string_view& line);
+    size_t getLineNumber() const;
+
+    static size_t splitFields(string_view line, char delimiter, string_view* fields,
+                              size_t maxFields);
+    static size_t splitWhitespace(string_view line, string_view* fields, size_t maxFields);
+    static bool parseInt(string_view text, int& value);
+    static bool parseDouble(string_view text, double& value);
+};
+
+#endif
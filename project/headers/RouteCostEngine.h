@@ -0,0 +1,88 @@
+#ifndef ROUTE_COST_ENGINE_H
+#define ROUTE_COST_ENGINE_H
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+#include <cstddef>
+#include "Airplane.h"
+#include "Destination.h"
+#include "SlotMap.h"
+
+using namespace std;
+
+// Празно летище на излитане означава, че маршрутът може да се изпълни
+// от самолет с произволна база.
+struct RouteRequest {
+    string destinationCode;
+    int passengers;
+    string originAirportCode;
+};
+
+enum RouteStatus {
+    ROUTE_ASSIGNED,
+    ROUTE_UNKNOWN_DESTINATION,
+    ROUTE_INVALID_LOAD,
+    ROUTE_NO_AIRPLANE,
+    ROUTE_FLEET_EXHAUSTED
+};
+
+struct RouteCost {
+    SlotHandle<Airplane> airplane;
+    double fuelLiters;
+    double flightHours;
+    double cost;
+};
+
+struct RouteAssignment {
+    RouteStatus status;
+    size_t compatibleAirplanes;
+    RouteCost selected;
+};
+
+// Пакетно изчисляване на гориво, време и разходи за полет по маршрути.
+// Данните за самолетите се пазят по колони, така че един маршрут се
+// пресмята наведнъж за блок от самолети без разклонения и изключения;
+// отделните маршрути се разпределят между нишки. Разстоянието до
+// дестинацията се подава за всяка база, а всеки самолет се проверява и
+// оценява с разстоянието от своята база.
+class RouteCostEngine {
+private:
+    vector<double> minRunwayLengths_;
+    vector<double> maxRanges_;
+    vector<double> fuelPerKmPerSeat_;
+    vector<double> averageSpeeds_;
+    vector<int32_t> seatCounts_;
+    vector<uint8_t> operational_;
+    vector<uint32_t> baseAirports_;
+    vector<SlotHandle<Airplane> > handles_;
+    vector<string> baseAirportCodes_;
+    unordered_map<string, uint32_t> baseAirportIds_;
+
+    uint32_t originFilter(const string& originAirportCode) const;
+    RouteCost costAt(size_t position, double distance, int passengers) const;
+
+public:
+    RouteCostEngine();
+    RouteCostEngine(const vector<Airplane>& airplanes,
+                    const vector<SlotHandle<Airplane> >& handles);
+
+    size_t size() const;
+    // Базите на самолетите, номерирани по реда на първата поява.
+    const vector<string>& getBaseAirportCodes() const;
+
+    // baseDistances[b] е разстоянието от база b до дестинацията.
+    void evaluate(const Destination& destination, const RouteRequest& route,
+                  const double* baseDistances, vector<RouteCost>& costs) const;
+    RouteAssignment findCheapest(const Destination* destination, const RouteRequest& route,
+                                 const double* baseDistances) const;
+    // baseDistances[route * getBaseAirportCodes().size() + b] е разстоянието
+    // от база b до дестинацията на маршрута.
+    vector<RouteAssignment> assignCheapest(const vector<const Destination*>& destinations,
+                                           const vector<RouteRequest>& routes,
+                                           const vector<double>& baseDistances,
+                                           unsigned threadCount) const;
+};
+
+#endif
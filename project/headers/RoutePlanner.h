@@ -0,0 +1,79 @@
+#ifndef ROUTE_PLANNER_H
+#define ROUTE_PLANNER_H
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <memory>
+#include <cstdint>
+#include <cstddef>
+#include "Destination.h"
+#include "GeoIndex.h"
+#include "PlaneClass.h"
+
+using namespace std;
+
+enum RoutingObjective {
+    ROUTING_MIN_STOPS,
+    ROUTING_MIN_FUEL
+};
+
+enum FlightPlanStatus {
+    FLIGHT_PLANNED,
+    FLIGHT_UNKNOWN_CLASS,
+    FLIGHT_UNKNOWN_AIRPORT,
+    FLIGHT_NO_COORDINATES,
+    FLIGHT_RUNWAY_TOO_SHORT,
+    FLIGHT_UNREACHABLE
+};
+
+struct FlightLeg {
+    string fromCode;
+    string toCode;
+    double distanceKm;
+    double fuelLiters;
+};
+
+struct FlightPlan {
+    FlightPlanStatus status;
+    vector<FlightLeg> legs;
+    double totalDistanceKm;
+    double totalFuelLiters;
+};
+
+// Търси маршрут с междинни кацания за зареждане между две дестинации с
+// координати. За всеки клас се строи граф на достижимостта: върхове са
+// летищата, чиито писти класът може да ползва, а ребра - полетите в
+// рамките на максималния му обхват. Графът се пази в кеша до
+// унищожаването на обекта, затова при промяна на дестинациите или на
+// класовете се строи нов RoutePlanner.
+class RoutePlanner {
+private:
+    // Ребрата на връх v са targets/distances[firstEdge[v], firstEdge[v + 1]).
+    struct ReachabilityGraph {
+        vector<uint32_t> nodeByPosition;
+        vector<uint32_t> positions;
+        vector<uint32_t> firstEdge;
+        vector<uint32_t> targets;
+        vector<double> distances;
+    };
+
+    vector<Destination> destinations_;
+    unordered_map<string, uint32_t> positionsByCode_;
+    GeoIndex geoIndex_;
+    mutable unordered_map<string, shared_ptr<const ReachabilityGraph> > graphs_;
+
+    shared_ptr<const ReachabilityGraph> buildGraph(const PlaneClass& planeClass) const;
+    shared_ptr<const ReachabilityGraph> graphFor(const PlaneClass& planeClass) const;
+
+public:
+    explicit RoutePlanner(const vector<Destination>& destinations);
+
+    size_t size() const;
+    size_t getCachedClassCount() const;
+
+    FlightPlan planFlight(const PlaneClass& planeClass, const string& originCode,
+                          const string& targetCode, RoutingObjective objective) const;
+};
+
+#endif
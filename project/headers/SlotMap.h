@@ -0,0 +1,147 @@
+#ifndef SLOT_MAP_H
+#define SLOT_MAP_H
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <utility>
+
+using namespace std;
+
+template <typename T>
+struct SlotHandle {
+    uint32_t index;
+    uint32_t generation;
+
+    SlotHandle() : index(UINT32_MAX), generation(0) {}
+    SlotHandle(uint32_t slotIndex, uint32_t slotGeneration)
+        : index(slotIndex), generation(slotGeneration) {}
+
+    bool isNull() const { return index == UINT32_MAX; }
+    bool operator==(const SlotHandle& other) const {
+        return index == other.index && generation == other.generation;
+    }
+    bool operator!=(const SlotHandle& other) const { return !(*this == other); }
+};
+
+template <typename T>
+struct SlotHandleHash {
+    size_t operator()(const SlotHandle<T>& handle) const {
+        return (static_cast<size_t>(handle.generation) << 32) ^ handle.index;
+    }
+};
+
+// Плътен масив от стойности + таблица със слотове. Премахването мести
+// последния елемент на мястото на изтрития, а манипулаторите (handles)
+// остават валидни, докато самият им елемент не бъде премахнат.
+template <typename T>
+class SlotMap {
+private:
+    struct Slot {
+        uint32_t denseIndex;
+        uint32_t generation;
+    };
+
+    vector<T> values_;
+    vector<uint32_t> denseToSlot_;
+    vector<Slot> slots_;
+    vector<uint32_t> freeSlots_;
+
+public:
+    typedef SlotHandle<T> Handle;
+
+    SlotMap() : values_(), denseToSlot_(), slots_(), freeSlots_() {}
+
+    Handle insert(const T& value) {
+        values_.push_back(value);
+        return attachLast();
+    }
+
+    Handle insert(T&& value) {
+        values_.push_back(move(value));
+        return attachLast();
+    }
+
+    bool erase(Handle handle) {
+        if (!contains(handle)) {
+            return false;
+        }
+        uint32_t removedIndex = slots_[handle.index].denseIndex;
+        uint32_t lastIndex = static_cast<uint32_t>(values_.size() - 1);
+        if (removedIndex != lastIndex) {
+            values_[removedIndex] = move(values_[lastIndex]);
+            denseToSlot_[removedIndex] = denseToSlot_[lastIndex];
+            slots_[denseToSlot_[removedIndex]].denseIndex = removedIndex;
+        }
+        values_.pop_back();
+        denseToSlot_.pop_back();
+        ++slots_[handle.index].generation;
+        freeSlots_.push_back(handle.index);
+        return true;
+    }
+
+    bool contains(Handle handle) const {
+        return handle.index < slots_.size() &&
+               slots_[handle.index].generation == handle.generation &&
+               !isFree(handle.index);
+    }
+
+    T* get(Handle handle) {
+        return contains(handle) ? &values_[slots_[handle.index].denseIndex] : nullptr;
+    }
+
+    const T* get(Handle handle) const {
+        return contains(handle) ? &values_[slots_[handle.index].denseIndex] : nullptr;
+    }
+
+    size_t denseIndexOf(Handle handle) const { return slots_[handle.index].denseIndex; }
+
+    Handle handleAt(size_t denseIndex) const {
+        uint32_t slotIndex = denseToSlot_[denseIndex];
+        return Handle(slotIndex, slots_[slotIndex].generation);
+    }
+
+    const vector<T>& values() const { return values_; }
+
+    size_t size() const { return values_.size(); }
+    bool empty() const { return values_.empty(); }
+    size_t capacity() const { return values_.capacity(); }
+
+    void reserve(size_t count) {
+        values_.reserve(count);
+        denseToSlot_.reserve(count);
+        slots_.reserve(count);
+    }
+
+    void clear() {
+        for (uint32_t slotIndex : denseToSlot_) {
+            ++slots_[slotIndex].generation;
+            freeSlots_.push_back(slotIndex);
+        }
+        values_.clear();
+        denseToSlot_.clear();
+    }
+
+private:
+    // Дава слот на току-що добавения последен елемент.
+    Handle attachLast() {
+        uint32_t slotIndex;
+        if (!freeSlots_.empty()) {
+            slotIndex = freeSlots_.back();
+            freeSlots_.pop_back();
+        } else {
+            slotIndex = static_cast<uint32_t>(slots_.size());
+            slots_.push_back(Slot{0, 0});
+        }
+        denseToSlot_.push_back(slotIndex);
+        slots_[slotIndex].denseIndex = static_cast<uint32_t>(values_.size() - 1);
+        return Handle(slotIndex, slots_[slotIndex].generation);
+    }
+
+    bool isFree(uint32_t slotIndex) const {
+        uint32_t denseIndex = slots_[slotIndex].denseIndex;
+        return denseIndex >= denseToSlot_.size() || denseToSlot_[denseIndex] != slotIndex;
+    }
+};
+
+#endif
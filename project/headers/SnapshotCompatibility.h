@@ -0,0 +1,45 @@
+#ifndef SNAPSHOT_COMPATIBILITY_H
+#define SNAPSHOT_COMPATIBILITY_H
+
+#include <string>
+#include <cstdint>
+#include <cstddef>
+#include "Airplane.h"
+#include "PersistentVector.h"
+#include "PersistentMap.h"
+
+using namespace std;
+
+// Данните, по които версия на флота отговаря на заявките за съвместимост,
+// без да стига до самолетите и класовете им. Записът на позиция i е за
+// самолета на същата позиция във версията. Както самолетите, записите са в
+// устойчиви структури и версиите споделят непроменените им възли. Базите
+// само се добавят, затова номерата им не се менят при премахване на самолет.
+class SnapshotCompatibility {
+public:
+    struct Entry {
+        double minRunwayLength;
+        double maxRange;
+        uint32_t baseAirport;
+        bool operational;
+    };
+
+private:
+    PersistentVector<Entry> entries_;
+    PersistentVector<string> baseAirportCodes_;
+    PersistentMap<string, uint32_t> baseAirportIds_;
+
+public:
+    SnapshotCompatibility();
+
+    size_t size() const;
+    const PersistentVector<Entry>& getEntries() const;
+    const PersistentVector<string>& getBaseAirportCodes() const;
+
+    // При position == size() записът се добавя в края.
+    void set(size_t position, const Airplane& airplane);
+    void popBack();
+    void clear();
+};
+
+#endif
@@ -5,21 +5,27 @@
 using namespace std;
 
 Airplane::Airplane()
-    : identificationNumber_(""), planeClass_(), isOperational_(false),
-      baseAirportCode_(""), totalFlightHours_(0) {}
+    : identificationNumber_(""), planeClass_(make_shared<PlaneClass>()),
+      isOperational_(false), baseAirportCode_(""), totalFlightHours_(0) {}
 
 Airplane::Airplane(const string &id, const PlaneClass &planeClass)
-    : identificationNumber_(""), planeClass_(planeClass), isOperational_(true),
-      baseAirportCode_(""), totalFlightHours_(0) {
+    : identificationNumber_(""), planeClass_(make_shared<PlaneClass>(planeClass)),
+      isOperational_(true), baseAirportCode_(""), totalFlightHours_(0) {
     setIdentificationNumber(id);
 }
 
 Airplane::Airplane(const string &id, const PlaneClass &planeClass,
                    bool operational, const string &baseAirport, int flightHours)
-    : identificationNumber_(""), planeClass_(planeClass),
-      isOperational_(operational), baseAirportCode_(baseAirport),
+    : Airplane(id, make_shared<PlaneClass>(planeClass), operational, baseAirport,
+               flightHours) {}
+
+Airplane::Airplane(string id, const shared_ptr<const PlaneClass> &planeClass,
+                   bool operational, string baseAirport, int flightHours)
+    : identificationNumber_(""), planeClass_(),
+      isOperational_(operational), baseAirportCode_(move(baseAirport)),
       totalFlightHours_(0) {
-    setIdentificationNumber(id);
+    setIdentificationNumber(move(id));
+    setPlaneClass(planeClass);
     setTotalFlightHours(flightHours);
 }
 
@@ -29,30 +35,49 @@ Airplane::Airplane(const Airplane &other)
       baseAirportCode_(other.baseAirportCode_),
       totalFlightHours_(other.totalFlightHours_) {}
 
+Airplane::Airplane(Airplane &&other) noexcept
+    : identificationNumber_(move(other.identificationNumber_)),
+      planeClass_(move(other.planeClass_)), isOperational_(other.isOperational_),
+      baseAirportCode_(move(other.baseAirportCode_)),
+      totalFlightHours_(other.totalFlightHours_) {}
+
 Airplane::~Airplane() {}
 
 string Airplane::getIdentificationNumber() const {
     return identificationNumber_;
 }
 
-PlaneClass Airplane::getPlaneClass() const { return planeClass_; }
+const string &Airplane::getIdentificationNumberRef() const { return identificationNumber_; }
+
+PlaneClass Airplane::getPlaneClass() const { return *planeClass_; }
 
 bool Airplane::isOperational() const { return isOperational_; }
 
 string Airplane::getBaseAirportCode() const { return baseAirportCode_; }
 
+const string &Airplane::getBaseAirportCodeRef() const { return baseAirportCode_; }
+
 int Airplane::getTotalFlightHours() const { return totalFlightHours_; }
 
-const PlaneClass &Airplane::getPlaneClassRef() const { return planeClass_; }
+const PlaneClass &Airplane::getPlaneClassRef() const { return *planeClass_; }
+
+const shared_ptr<const PlaneClass> &Airplane::getSharedPlaneClass() const { return planeClass_; }
 
-void Airplane::setIdentificationNumber(const string &id) {
+void Airplane::setIdentificationNumber(string id) {
     if (id.empty()) {
         throw invalid_argument("Идентификационният номер на самолета не може да е празен");
     }
-    identificationNumber_ = id;
+    identificationNumber_ = move(id);
 }
 
 void Airplane::setPlaneClass(const PlaneClass &planeClass) {
+    planeClass_ = make_shared<PlaneClass>(planeClass);
+}
+
+void Airplane::setPlaneClass(const shared_ptr<const PlaneClass> &planeClass) {
+    if (!planeClass) {
+        throw invalid_argument("Класът на самолета не може да липсва");
+    }
     planeClass_ = planeClass;
 }
 
@@ -75,10 +100,10 @@ bool Airplane::canFlyToDestination(double runwayLength, double distance) const {
     if (!isOperational_) {
         return false;
     }
-    if (!planeClass_.isCompatibleWithRunway(runwayLength)) {
+    if (!planeClass_->isCompatibleWithRunway(runwayLength)) {
         return false;
     }
-    if (distance > planeClass_.calculateMaxRange()) {
+    if (distance > planeClass_->calculateMaxRange()) {
         return false;
     }
     return true;
@@ -91,7 +116,7 @@ double Airplane::calculateOperatingCost(double distanceKm, int passengers) const
     if (passengers < 0) {
         throw invalid_argument("Броят пътници не може да е отрицателен");
     }
-    return planeClass_.calculateFuelConsumption(distanceKm, passengers) * 0.80;
+    return planeClass_->calculateFuelConsumption(distanceKm, passengers) * FUEL_PRICE_PER_LITER;
 }
 
 void Airplane::addFlightHours(int hours) {
@@ -113,18 +138,30 @@ Airplane &Airplane::operator=(const Airplane &other) {
     return *this;
 }
 
+Airplane &Airplane::operator=(Airplane &&other) noexcept {
+    if (this == &other) {
+        return *this;
+    }
+    identificationNumber_ = move(other.identificationNumber_);
+    planeClass_ = move(other.planeClass_);
+    isOperational_ = other.isOperational_;
+    baseAirportCode_ = move(other.baseAirportCode_);
+    totalFlightHours_ = other.totalFlightHours_;
+    return *this;
+}
+
 ostream &operator<<(ostream &os, const Airplane &airplane) {
     os << "Информация за самолет" << endl;
     os << "ID номер:            " << airplane.identificationNumber_ << endl;
-    os << "Клас самолет:        " << airplane.planeClass_.getClassId() << endl;
+    os << "Клас самолет:        " << airplane.planeClass_->getClassId() << endl;
     os << "Оперативен:          " << (airplane.isOperational_ ? "Да" : "Не") << endl;
     os << "Базово летище:       "
        << (airplane.baseAirportCode_.empty() ? "Неопределено" : airplane.baseAirportCode_) << endl;
     os << "Общо летателни часове: " << airplane.totalFlightHours_ << " часа" << endl;
-    os << "Капацитет места:     " << airplane.planeClass_.getSeatCount() << endl;
+    os << "Капацитет места:     " << airplane.planeClass_->getSeatCount() << endl;
     os << "Максимален обхват:   " << fixed << setprecision(2)
-       << airplane.planeClass_.calculateMaxRange() << " км" << endl;
-    os << "Мин. необх. писта:   " << airplane.planeClass_.getMinRunwayLength() << " м" << endl;
+       << airplane.planeClass_->calculateMaxRange() << " км" << endl;
+    os << "Мин. необх. писта:   " << airplane.planeClass_->getMinRunwayLength() << " м" << endl;
     return os;
 }
 
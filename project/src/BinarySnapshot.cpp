@@ -0,0 +1,95 @@
+#include "../headers/BinarySnapshot.h"
+#include <cstring>
+
+using namespace std;
+
+SnapshotStringTable::SnapshotStringTable() : data_(), offsets_() {}
+
+SnapshotString SnapshotStringTable::add(const string &value) {
+    auto found = offsets_.find(value);
+    if (found != offsets_.end()) {
+        return SnapshotString{found->second, static_cast<uint32_t>(value.size())};
+    }
+    uint32_t offset = static_cast<uint32_t>(data_.size());
+    data_ += value;
+    offsets_.emplace(value, offset);
+    return SnapshotString{offset, static_cast<uint32_t>(value.size())};
+}
+
+const string &SnapshotStringTable::getData() const { return data_; }
+
+uint64_t computeSnapshotChecksum(const char *data, size_t size) {
+    uint64_t hash = 14695981039346656037ULL;
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= static_cast<unsigned char>(data[i]);
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+bool isSnapshotStringValid(const SnapshotString &value, uint64_t stringTableSize) {
+    return static_cast<uint64_t>(value.offset) + value.length <= stringTableSize;
+}
+
+bool validateSnapshot(const char *data, size_t size) {
+    if (size < sizeof(SnapshotHeader)) {
+        return false;
+    }
+    const SnapshotHeader *header = reinterpret_cast<const SnapshotHeader *>(data);
+    if (memcmp(header->magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC)) != 0 ||
+        header->version != SNAPSHOT_VERSION || header->headerSize != sizeof(SnapshotHeader)) {
+        return false;
+    }
+
+    uint64_t classEnd = header->planeClassOffset +
+                        static_cast<uint64_t>(header->planeClassCount) * sizeof(SnapshotPlaneClass);
+    uint64_t airplaneEnd = header->airplaneOffset +
+                           static_cast<uint64_t>(header->airplaneCount) * sizeof(SnapshotAirplane);
+    uint64_t destinationEnd =
+        header->destinationOffset +
+        static_cast<uint64_t>(header->destinationCount) * sizeof(SnapshotDestination);
+    if (header->planeClassOffset != sizeof(SnapshotHeader) ||
+        header->airplaneOffset != classEnd || header->destinationOffset != airplaneEnd ||
+        header->stringTableOffset != destinationEnd ||
+        header->stringTableOffset + header->stringTableSize != size) {
+        return false;
+    }
+
+    if (computeSnapshotChecksum(data + sizeof(SnapshotHeader), size - sizeof(SnapshotHeader)) !=
+        header->checksum) {
+        return false;
+    }
+
+    uint64_t stringTableSize = header->stringTableSize;
+    if (!isSnapshotStringValid(header->companyName, stringTableSize)) {
+        return false;
+    }
+    const SnapshotPlaneClass *planeClasses =
+        reinterpret_cast<const SnapshotPlaneClass *>(data + header->planeClassOffset);
+    for (uint32_t i = 0; i < header->planeClassCount; ++i) {
+        if (!isSnapshotStringValid(planeClasses[i].manufacturer, stringTableSize) ||
+            !isSnapshotStringValid(planeClasses[i].model, stringTableSize)) {
+            return false;
+        }
+    }
+    const SnapshotAirplane *airplanes =
+        reinterpret_cast<const SnapshotAirplane *>(data + header->airplaneOffset);
+    for (uint32_t i = 0; i < header->airplaneCount; ++i) {
+        if (!isSnapshotStringValid(airplanes[i].identificationNumber, stringTableSize) ||
+            !isSnapshotStringValid(airplanes[i].baseAirportCode, stringTableSize) ||
+            airplanes[i].planeClassIndex >= header->planeClassCount) {
+            return false;
+        }
+    }
+    const SnapshotDestination *destinations =
+        reinterpret_cast<const SnapshotDestination *>(data + header->destinationOffset);
+    for (uint32_t i = 0; i < header->destinationCount; ++i) {
+        if (!isSnapshotStringValid(destinations[i].code, stringTableSize) ||
+            !isSnapshotStringValid(destinations[i].name, stringTableSize) ||
+            !isSnapshotStringValid(destinations[i].city, stringTableSize) ||
+            !isSnapshotStringValid(destinations[i].country, stringTableSize)) {
+            return false;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,451 @@
+#include "../headers/CommandInterpreter.h"
+#include "../headers/FleetCsv.h"
+#include "../headers/RecordReader.h"
+
+using namespace std;
+
+namespace {
+
+// Използва се, когато командата е разпозната, но аргументите не са валидни.
+struct BadArguments {};
+
+string stringArgument(string_view text) { return string(text); }
+
+int intArgument(string_view text) {
+    int value;
+    if (!RecordReader::parseInt(text, value)) {
+        throw BadArguments();
+    }
+    return value;
+}
+
+double doubleArgument(string_view text) {
+    double value;
+    if (!RecordReader::parseDouble(text, value)) {
+        throw BadArguments();
+    }
+    return value;
+}
+
+bool boolArgument(string_view text) {
+    int value = intArgument(text);
+    if (value != 0 && value != 1) {
+        throw BadArguments();
+    }
+    return value == 1;
+}
+
+}
+
+CommandInterpreter::CommandInterpreter(FleetManager &manager)
+    : manager_(manager), executedCount_(0), failedCount_(0), readOnly_(false) {}
+
+bool CommandInterpreter::execute(string_view line, ostream &out) {
+    string_view fields[MAX_FIELDS];
+    size_t count = RecordReader::splitFields(line, '\t', fields, MAX_FIELDS);
+    ++executedCount_;
+    if (count > MAX_FIELDS) {
+        ++failedCount_;
+        writeError(out, "bad_arguments", "твърде много полета");
+        return true;
+    }
+
+    if (readOnly_ && isMutating(fields[0])) {
+        ++failedCount_;
+        writeError(out, "read_only", "командата променя данните");
+        return true;
+    }
+
+    try {
+        return dispatch(fields, count, out);
+    } catch (const BadArguments &) {
+        ++failedCount_;
+        writeError(out, "bad_arguments", "невалидни аргументи за " + stringArgument(fields[0]));
+    } catch (const exception &e) {
+        ++failedCount_;
+        writeError(out, "invalid", e.what());
+    }
+    return true;
+}
+
+void CommandInterpreter::run(istream &in, ostream &out) {
+    string line;
+    while (getline(in, line)) {
+        if (!line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+        if (!execute(line, out)) {
+            break;
+        }
+        // Изходът се изпраща само когато няма още готов вход, за да не се
+        // прави системно извикване след всяка команда от дълъг скрипт.
+        if (in.rdbuf()->in_avail() <= 0) {
+            out.flush();
+        }
+    }
+    out.flush();
+}
+
+void CommandInterpreter::setReadOnly(bool readOnly) { readOnly_ = readOnly; }
+
+size_t CommandInterpreter::getExecutedCount() const { return executedCount_; }
+
+size_t CommandInterpreter::getFailedCount() const { return failedCount_; }
+
+bool CommandInterpreter::isMutating(string_view command) {
+    return command.compare(0, 4, "add-") == 0 || command.compare(0, 7, "remove-") == 0 ||
+           command == "set-operational" || command == "set-class-operational" ||
+           command == "set-base" || command == "set-runway" || command == "save" ||
+           command == "load" || command == "import" || command == "export";
+}
+
+void CommandInterpreter::writeOk(ostream &out, size_t rowCount) {
+    out << "ok\t" << rowCount << '\n';
+}
+
+void CommandInterpreter::writeError(ostream &out, const string &code, const string &message) {
+    out << "error\t" << code << '\t' << message << '\n';
+}
+
+bool CommandInterpreter::dispatch(const string_view *fields, size_t count, ostream &out) {
+    string_view command = fields[0];
+    auto requireArguments = [count](size_t arguments) {
+        if (count != arguments + 1) {
+            throw BadArguments();
+        }
+    };
+    auto fail = [this, &out](const string &code, const string &message) {
+        ++failedCount_;
+        writeError(out, code, message);
+        return true;
+    };
+    const FleetManager &fleet = manager_;
+    CsvWriter rows(out, '\t');
+
+    if (command == "quit" || command == "exit") {
+        requireArguments(0);
+        writeOk(out, 0);
+        return false;
+    }
+    if (command == "add-class") {
+        requireArguments(8);
+        PlaneClass planeClass(stringArgument(fields[1]), stringArgument(fields[2]), intArgument(fields[3]),
+                              doubleArgument(fields[4]), doubleArgument(fields[5]),
+                              doubleArgument(fields[6]), doubleArgument(fields[7]),
+                              intArgument(fields[8]));
+        if (!manager_.addPlaneClass(planeClass)) {
+            return fail("duplicate", "класът вече съществува");
+        }
+        writeOk(out, 0);
+        return true;
+    }
+    if (command == "add-airplane") {
+        requireArguments(5);
+        shared_ptr<const PlaneClass> planeClass =
+            manager_.getSharedPlaneClass(manager_.findPlaneClassHandleById(stringArgument(fields[2])));
+        if (!planeClass) {
+            return fail("not_found", "непознат клас самолет");
+        }
+        Airplane airplane(stringArgument(fields[1]), planeClass, boolArgument(fields[3]),
+                          stringArgument(fields[4]), intArgument(fields[5]));
+        if (!manager_.addAirplane(airplane)) {
+            return fail("duplicate", "самолетът вече съществува");
+        }
+        writeOk(out, 0);
+        return true;
+    }
+    if (command == "add-destination") {
+        if (count != 9) {
+            requireArguments(6);
+        }
+        Destination destination(stringArgument(fields[1]), stringArgument(fields[2]), stringArgument(fields[3]),
+                                stringArgument(fields[4]), doubleArgument(fields[5]),
+                                doubleArgument(fields[6]));
+        if (count == 9) {
+            destination.setCoordinates(doubleArgument(fields[7]), doubleArgument(fields[8]));
+        }
+        if (!manager_.addDestination(destination)) {
+            return fail("duplicate", "дестинацията вече съществува");
+        }
+        writeOk(out, 0);
+        return true;
+    }
+    if (command == "remove-airplane") {
+        requireArguments(1);
+        if (!manager_.removeAirplaneById(stringArgument(fields[1]))) {
+            return fail("not_found", "няма такъв самолет");
+        }
+        writeOk(out, 0);
+        return true;
+    }
+    if (command == "remove-destination") {
+        requireArguments(1);
+        if (!manager_.removeDestinationByCode(stringArgument(fields[1]))) {
+            return fail("not_found", "няма такава дестинация");
+        }
+        writeOk(out, 0);
+        return true;
+    }
+    if (command == "set-operational") {
+        requireArguments(2);
+        if (!manager_.setAirplaneOperational(stringArgument(fields[1]), boolArgument(fields[2]))) {
+            return fail("not_found", "няма такъв самолет");
+        }
+        writeOk(out, 0);
+        return true;
+    }
+    if (command == "set-class-operational") {
+        requireArguments(2);
+        string classId = stringArgument(fields[1]);
+        if (fleet.findPlaneClassHandleById(classId).isNull()) {
+            return fail("not_found", "непознат клас самолет");
+        }
+        FleetTransaction transaction;
+        for (const auto &airplane : fleet.getAirplanes()) {
+            if (airplane.getPlaneClassRef().getClassIdRef() == classId) {
+                transaction.setAirplaneOperational(airplane.getIdentificationNumberRef(),
+                                                   boolArgument(fields[2]));
+            }
+        }
+        TransactionResult result = manager_.commitTransaction(transaction);
+        if (result.status != TRANSACTION_COMMITTED) {
+            return fail("rolled_back", result.message);
+        }
+        writeOk(out, 0);
+        return true;
+    }
+    if (command == "set-base") {
+        requireArguments(2);
+        if (!manager_.setAirplaneBase(stringArgument(fields[1]), stringArgument(fields[2]))) {
+            return fail("not_found", "няма такъв самолет");
+        }
+        writeOk(out, 0);
+        return true;
+    }
+    if (command == "set-runway") {
+        requireArguments(2);
+        if (!manager_.setDestinationRunwayLength(stringArgument(fields[1]),
+                                                 doubleArgument(fields[2]))) {
+            return fail("not_found", "няма такава дестинация");
+        }
+        writeOk(out, 0);
+        return true;
+    }
+    if (command == "add-hours") {
+        requireArguments(2);
+        if (!manager_.addAirplaneFlightHours(stringArgument(fields[1]), intArgument(fields[2]))) {
+            return fail("not_found", "няма такъв самолет");
+        }
+        writeOk(out, 0);
+        return true;
+    }
+    if (command == "get-airplane") {
+        requireArguments(1);
+        const Airplane *airplane =
+            fleet.getAirplane(fleet.findAirplaneHandleById(stringArgument(fields[1])));
+        if (airplane == nullptr) {
+            return fail("not_found", "няма такъв самолет");
+        }
+        writeOk(out, 1);
+        FleetCsv::writeAirplane(rows, *airplane);
+        return true;
+    }
+    if (command == "get-destination") {
+        requireArguments(1);
+        const Destination *destination =
+            fleet.getDestination(fleet.findDestinationHandleByCode(stringArgument(fields[1])));
+        if (destination == nullptr) {
+            return fail("not_found", "няма такава дестинация");
+        }
+        writeOk(out, 1);
+        FleetCsv::writeDestination(rows, *destination);
+        return true;
+    }
+    if (command == "find-nearby") {
+        requireArguments(2);
+        const Destination *center =
+            fleet.getDestination(fleet.findDestinationHandleByCode(stringArgument(fields[1])));
+        if (center == nullptr) {
+            return fail("not_found", "няма такава дестинация");
+        }
+        if (!center->hasCoordinates()) {
+            return fail("no_route", "летището няма координати");
+        }
+        vector<DestinationHandle> handles =
+            fleet.findDestinationHandlesWithinKm(center->getCodeRef(), doubleArgument(fields[2]));
+        writeOk(out, handles.size());
+        for (DestinationHandle handle : handles) {
+            FleetCsv::writeDestination(rows, *fleet.getDestination(handle));
+        }
+        return true;
+    }
+    if (command == "get-class") {
+        requireArguments(1);
+        const PlaneClass *planeClass =
+            fleet.getPlaneClass(fleet.findPlaneClassHandleById(stringArgument(fields[1])));
+        if (planeClass == nullptr) {
+            return fail("not_found", "непознат клас самолет");
+        }
+        writeOk(out, 1);
+        FleetCsv::writePlaneClass(rows, *planeClass);
+        return true;
+    }
+    if (command == "find-compatible" || command == "find-for-destination") {
+        vector<AirplaneHandle> handles;
+        if (command == "find-compatible") {
+            requireArguments(2);
+            handles = manager_.findCompatibleAirplaneHandles(doubleArgument(fields[1]),
+                                                             doubleArgument(fields[2]));
+        } else {
+            requireArguments(1);
+            if (manager_.findDestinationHandleByCode(stringArgument(fields[1])).isNull()) {
+                return fail("not_found", "няма такава дестинация");
+            }
+            handles = manager_.findAirplaneHandlesForDestination(stringArgument(fields[1]));
+        }
+        writeOk(out, handles.size());
+        for (AirplaneHandle handle : handles) {
+            FleetCsv::writeAirplane(rows, *fleet.getAirplane(handle));
+        }
+        return true;
+    }
+    if (command == "get-operational") {
+        requireArguments(0);
+        vector<AirplaneHandle> handles = fleet.getOperationalAirplaneHandles();
+        writeOk(out, handles.size());
+        for (AirplaneHandle handle : handles) {
+            FleetCsv::writeAirplane(rows, *fleet.getAirplane(handle));
+        }
+        return true;
+    }
+    if (command == "plan-route") {
+        requireArguments(2);
+        RouteRequest route{stringArgument(fields[1]), intArgument(fields[2]), string()};
+        RouteAssignment assignment = fleet.planRoutes(vector<RouteRequest>(1, route), 1).front();
+        if (assignment.status == ROUTE_UNKNOWN_DESTINATION) {
+            return fail("not_found", "няма такава дестинация");
+        }
+        if (assignment.status == ROUTE_INVALID_LOAD) {
+            throw BadArguments();
+        }
+        writeOk(out, 1);
+        FleetCsv::writeRouteAssignment(rows, fleet, route, assignment);
+        return true;
+    }
+    if (command == "plan-flight") {
+        requireArguments(4);
+        RoutingObjective objective;
+        if (fields[4] == "stops") {
+            objective = ROUTING_MIN_STOPS;
+        } else if (fields[4] == "fuel") {
+            objective = ROUTING_MIN_FUEL;
+        } else {
+            throw BadArguments();
+        }
+        FlightPlan plan = fleet.planFlight(stringArgument(fields[1]), stringArgument(fields[2]),
+                                           stringArgument(fields[3]), objective);
+        switch (plan.status) {
+        case FLIGHT_PLANNED:
+            break;
+        case FLIGHT_UNKNOWN_CLASS:
+            return fail("not_found", "непознат клас самолет");
+        case FLIGHT_UNKNOWN_AIRPORT:
+            return fail("not_found", "няма такава дестинация");
+        case FLIGHT_NO_COORDINATES:
+            return fail("no_route", "летището няма координати");
+        case FLIGHT_RUNWAY_TOO_SHORT:
+            return fail("no_route", "пистата е твърде къса за класа");
+        case FLIGHT_UNREACHABLE:
+            return fail("no_route", "целта е извън обхвата дори с междинни кацания");
+        }
+        writeOk(out, plan.legs.size());
+        for (const auto &leg : plan.legs) {
+            rows.field(leg.fromCode).field(leg.toCode).field(leg.distanceKm).field(leg.fuelLiters);
+            rows.endRecord();
+        }
+        return true;
+    }
+    if (command == "list-classes") {
+        requireArguments(0);
+        writeOk(out, manager_.getPlaneClassCount());
+        for (const auto &planeClass : manager_.getPlaneClasses()) {
+            FleetCsv::writePlaneClass(rows, *planeClass);
+        }
+        return true;
+    }
+    if (command == "list-airplanes") {
+        requireArguments(0);
+        writeOk(out, manager_.getAirplaneCount());
+        for (const auto &airplane : manager_.getAirplanes()) {
+            FleetCsv::writeAirplane(rows, airplane);
+        }
+        return true;
+    }
+    if (command == "list-destinations") {
+        requireArguments(0);
+        writeOk(out, manager_.getDestinationCount());
+        for (const auto &destination : manager_.getDestinations()) {
+            FleetCsv::writeDestination(rows, destination);
+        }
+        return true;
+    }
+    if (command == "count") {
+        requireArguments(0);
+        writeOk(out, 1);
+        rows.field(manager_.getPlaneClassCount())
+            .field(manager_.getAirplaneCount())
+            .field(manager_.getDestinationCount());
+        rows.endRecord();
+        return true;
+    }
+    if (command == "save") {
+        requireArguments(0);
+        if (!manager_.saveAllData()) {
+            return fail("io", "данните не са запазени");
+        }
+        writeOk(out, 0);
+        return true;
+    }
+    if (command == "load") {
+        requireArguments(0);
+        bool loaded = manager_.loadAllData();
+        const vector<LoadError> &errors = manager_.getLastLoadErrors();
+        if (!loaded) {
+            return fail("io", "данните не са заредени");
+        }
+        writeOk(out, errors.size());
+        for (const auto &error : errors) {
+            rows.field(error.filename).field(error.lineNumber).field(error.reason);
+            rows.endRecord();
+        }
+        return true;
+    }
+    if (command == "import") {
+        if (count != 3 && count != 4) {
+            throw BadArguments();
+        }
+        ImportSummary summary;
+        string rejectsFile = count == 4 ? stringArgument(fields[3]) : string();
+        if (!FleetCsv::importFile(manager_, stringArgument(fields[1]), stringArgument(fields[2]), rejectsFile,
+                                  summary)) {
+            return fail("io", "неуспешен импорт от " + stringArgument(fields[2]));
+        }
+        writeOk(out, 1);
+        rows.field(summary.imported).field(summary.duplicates).field(summary.rejected);
+        rows.endRecord();
+        return true;
+    }
+    if (command == "export") {
+        requireArguments(2);
+        if (!FleetCsv::exportFile(manager_, stringArgument(fields[1]), stringArgument(fields[2]))) {
+            return fail("io", "неуспешен експорт в " + stringArgument(fields[2]));
+        }
+        writeOk(out, 0);
+        return true;
+    }
+
+    return fail("unknown_command", "непозната команда " + stringArgument(command));
+}
@@ -0,0 +1,138 @@
+#include "../headers/CompatibilityIndex.h"
+#include <algorithm>
+
+using namespace std;
+
+namespace {
+
+const size_t QUERY_BLOCK_SIZE = 256;
+
+void computeMaskBlock(const double *minRunwayLengths, const double *maxRanges,
+                      const uint8_t *operational, const uint32_t *baseAirports, size_t count,
+                      double runwayLength, const double *baseDistances, uint8_t *mask) {
+    for (size_t i = 0; i < count; ++i) {
+        mask[i] = static_cast<uint8_t>((minRunwayLengths[i] <= runwayLength) &
+                                       (maxRanges[i] >= baseDistances[baseAirports[i]]) &
+                                       (operational[i] != 0));
+    }
+}
+
+// Същото при едно разстояние за всички бази; така заявката не заделя
+// памет за масив с по едно разстояние за база.
+void computeUniformMaskBlock(const double *minRunwayLengths, const double *maxRanges,
+                             const uint8_t *operational, size_t count, double runwayLength,
+                             double distance, uint8_t *mask) {
+    for (size_t i = 0; i < count; ++i) {
+        mask[i] = static_cast<uint8_t>((minRunwayLengths[i] <= runwayLength) &
+                                       (maxRanges[i] >= distance) & (operational[i] != 0));
+    }
+}
+
+}
+
+CompatibilityIndex::CompatibilityIndex()
+    : minRunwayLengths_(), maxRanges_(), operational_(), baseAirports_(), baseAirportCodes_(),
+      baseAirportIds_() {}
+
+size_t CompatibilityIndex::size() const { return operational_.size(); }
+
+size_t CompatibilityIndex::getBaseAirportCount() const { return baseAirportCodes_.size(); }
+
+const string &CompatibilityIndex::getBaseAirportCode(size_t baseAirport) const {
+    return baseAirportCodes_[baseAirport];
+}
+
+uint32_t CompatibilityIndex::baseAirportId(const string &code) {
+    auto found = baseAirportIds_.find(code);
+    if (found != baseAirportIds_.end()) {
+        return found->second;
+    }
+    uint32_t id = static_cast<uint32_t>(baseAirportCodes_.size());
+    baseAirportIds_.emplace(code, id);
+    baseAirportCodes_.push_back(code);
+    return id;
+}
+
+void CompatibilityIndex::append(const Airplane &airplane) {
+    const PlaneClass &planeClass = airplane.getPlaneClassRef();
+    minRunwayLengths_.push_back(planeClass.getMinRunwayLength());
+    maxRanges_.push_back(planeClass.calculateMaxRange());
+    operational_.push_back(airplane.isOperational() ? 1 : 0);
+    baseAirports_.push_back(baseAirportId(airplane.getBaseAirportCodeRef()));
+}
+
+void CompatibilityIndex::update(size_t position, const Airplane &airplane) {
+    const PlaneClass &planeClass = airplane.getPlaneClassRef();
+    minRunwayLengths_[position] = planeClass.getMinRunwayLength();
+    maxRanges_[position] = planeClass.calculateMaxRange();
+    operational_[position] = airplane.isOperational() ? 1 : 0;
+    baseAirports_[position] = baseAirportId(airplane.getBaseAirportCodeRef());
+}
+
+void CompatibilityIndex::removeBySwapWithLast(size_t position) {
+    size_t last = operational_.size() - 1;
+    minRunwayLengths_[position] = minRunwayLengths_[last];
+    maxRanges_[position] = maxRanges_[last];
+    operational_[position] = operational_[last];
+    baseAirports_[position] = baseAirports_[last];
+    minRunwayLengths_.pop_back();
+    maxRanges_.pop_back();
+    operational_.pop_back();
+    baseAirports_.pop_back();
+}
+
+void CompatibilityIndex::clear() {
+    minRunwayLengths_.clear();
+    maxRanges_.clear();
+    operational_.clear();
+    baseAirports_.clear();
+    baseAirportCodes_.clear();
+    baseAirportIds_.clear();
+}
+
+void CompatibilityIndex::findCompatible(double runwayLength, double distance,
+                                        vector<uint32_t> &positions) const {
+    uint8_t mask[QUERY_BLOCK_SIZE];
+    size_t total = size();
+    for (size_t start = 0; start < total; start += QUERY_BLOCK_SIZE) {
+        size_t count = min(QUERY_BLOCK_SIZE, total - start);
+        computeUniformMaskBlock(&minRunwayLengths_[start], &maxRanges_[start],
+                                &operational_[start], count, runwayLength, distance, mask);
+        for (size_t i = 0; i < count; ++i) {
+            if (mask[i] != 0) {
+                positions.push_back(static_cast<uint32_t>(start + i));
+            }
+        }
+    }
+}
+
+void CompatibilityIndex::findCompatible(double runwayLength, const double *baseDistances,
+                                        vector<uint32_t> &positions) const {
+    uint8_t mask[QUERY_BLOCK_SIZE];
+    size_t total = size();
+    for (size_t start = 0; start < total; start += QUERY_BLOCK_SIZE) {
+        size_t count = min(QUERY_BLOCK_SIZE, total - start);
+        computeMaskBlock(&minRunwayLengths_[start], &maxRanges_[start], &operational_[start],
+                         &baseAirports_[start], count, runwayLength, baseDistances, mask);
+        for (size_t i = 0; i < count; ++i) {
+            if (mask[i] != 0) {
+                positions.push_back(static_cast<uint32_t>(start + i));
+            }
+        }
+    }
+}
+
+void CompatibilityIndex::markCompatible(double runwayLength, const double *baseDistances,
+                                        uint64_t *bits) const {
+    uint8_t mask[QUERY_BLOCK_SIZE];
+    size_t total = size();
+    for (size_t start = 0; start < total; start += QUERY_BLOCK_SIZE) {
+        size_t count = min(QUERY_BLOCK_SIZE, total - start);
+        computeMaskBlock(&minRunwayLengths_[start], &maxRanges_[start], &operational_[start],
+                         &baseAirports_[start], count, runwayLength, baseDistances, mask);
+        for (size_t i = 0; i < count; ++i) {
+            size_t position = start + i;
+            bits[position / 64] |= static_cast<uint64_t>(mask[i]) << (position % 64);
+        }
+    }
+}
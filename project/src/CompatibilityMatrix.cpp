@@ -0,0 +1,118 @@
+#include "../headers/CompatibilityMatrix.h"
+#include <algorithm>
+#include <thread>
+
+using namespace std;
+
+CompatibilityMatrix::CompatibilityMatrix()
+    : wordsPerRow_(0), bits_(), airplanesPerDestination_(),
+      destinationsPerAirplane_(), destinations_(), airplanes_() {}
+
+CompatibilityMatrix CompatibilityMatrix::compute(const CompatibilityIndex &index,
+                                                 const vector<Destination> &destinations,
+                                                 const vector<double> &baseDistances,
+                                                 unsigned threadCount) {
+    CompatibilityMatrix matrix;
+    size_t rowCount = destinations.size();
+    size_t columnCount = index.size();
+    size_t baseAirportCount = index.getBaseAirportCount();
+    matrix.wordsPerRow_ = (columnCount + 63) / 64;
+    matrix.bits_.assign(rowCount * matrix.wordsPerRow_, 0);
+    matrix.airplanesPerDestination_.assign(rowCount, 0);
+    matrix.destinationsPerAirplane_.assign(columnCount, 0);
+
+    if (threadCount == 0) {
+        threadCount = max(1u, thread::hardware_concurrency());
+    }
+    size_t workerCount = min<size_t>(threadCount, max<size_t>(rowCount, 1));
+    size_t rowsPerWorker = (rowCount + workerCount - 1) / workerCount;
+    vector<vector<uint32_t> > partialColumnCounts(workerCount);
+
+    auto fillRows = [&](size_t worker) {
+        vector<uint32_t> &columnCounts = partialColumnCounts[worker];
+        columnCounts.assign(columnCount, 0);
+        size_t firstRow = worker * rowsPerWorker;
+        size_t lastRow = min(rowCount, firstRow + rowsPerWorker);
+        for (size_t row = firstRow; row < lastRow; ++row) {
+            uint64_t *words = &matrix.bits_[row * matrix.wordsPerRow_];
+            index.markCompatible(destinations[row].getRunwayLengthMeters(),
+                                 baseDistances.data() + row * baseAirportCount, words);
+
+            uint32_t rowTotal = 0;
+            for (size_t w = 0; w < matrix.wordsPerRow_; ++w) {
+                uint64_t word = words[w];
+                while (word != 0) {
+                    ++columnCounts[w * 64 + __builtin_ctzll(word)];
+                    ++rowTotal;
+                    word &= word - 1;
+                }
+            }
+            matrix.airplanesPerDestination_[row] = rowTotal;
+        }
+    };
+
+    vector<thread> workers;
+    for (size_t worker = 1; worker < workerCount; ++worker) {
+        workers.emplace_back(fillRows, worker);
+    }
+    fillRows(0);
+    for (auto &worker : workers) {
+        worker.join();
+    }
+
+    for (const auto &columnCounts : partialColumnCounts) {
+        for (size_t column = 0; column < columnCount; ++column) {
+            matrix.destinationsPerAirplane_[column] += columnCounts[column];
+        }
+    }
+    return matrix;
+}
+
+size_t CompatibilityMatrix::getDestinationCount() const {
+    return airplanesPerDestination_.size();
+}
+
+size_t CompatibilityMatrix::getAirplaneCount() const {
+    return destinationsPerAirplane_.size();
+}
+
+bool CompatibilityMatrix::isCompatible(size_t destinationRow, size_t airplaneColumn) const {
+    uint64_t word = bits_[destinationRow * wordsPerRow_ + airplaneColumn / 64];
+    return ((word >> (airplaneColumn % 64)) & 1) != 0;
+}
+
+size_t CompatibilityMatrix::countAirplanesForDestination(size_t destinationRow) const {
+    return airplanesPerDestination_[destinationRow];
+}
+
+size_t CompatibilityMatrix::countDestinationsForAirplane(size_t airplaneColumn) const {
+    return destinationsPerAirplane_[airplaneColumn];
+}
+
+vector<size_t> CompatibilityMatrix::getAirplaneColumns(size_t destinationRow) const {
+    vector<size_t> columns;
+    columns.reserve(airplanesPerDestination_[destinationRow]);
+    const uint64_t *words = &bits_[destinationRow * wordsPerRow_];
+    for (size_t w = 0; w < wordsPerRow_; ++w) {
+        uint64_t word = words[w];
+        while (word != 0) {
+            columns.push_back(w * 64 + __builtin_ctzll(word));
+            word &= word - 1;
+        }
+    }
+    return columns;
+}
+
+SlotHandle<Destination> CompatibilityMatrix::getDestinationHandle(size_t destinationRow) const {
+    return destinations_[destinationRow];
+}
+
+SlotHandle<Airplane> CompatibilityMatrix::getAirplaneHandle(size_t airplaneColumn) const {
+    return airplanes_[airplaneColumn];
+}
+
+void CompatibilityMatrix::setHandles(const vector<SlotHandle<Destination> > &destinations,
+                                     const vector<SlotHandle<Airplane> > &airplanes) {
+    destinations_ = destinations;
+    airplanes_ = airplanes;
+}
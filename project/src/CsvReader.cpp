@@ -0,0 +1,89 @@
+#include "../headers/CsvReader.h"
+
+using namespace std;
+
+CsvReader::CsvReader(istream &input, char delimiter)
+    : input_(input), delimiter_(delimiter), lineNumber_(1), recordLineNumber_(0),
+      malformed_(false) {}
+
+bool CsvReader::nextRecord(vector<string> &fields) {
+    streambuf *buffer = input_.rdbuf();
+    const int eof = char_traits<char>::eof();
+
+    while (buffer->sgetc() == '\n' || buffer->sgetc() == '\r') {
+        if (buffer->sbumpc() == '\n') {
+            ++lineNumber_;
+        }
+    }
+    if (buffer->sgetc() == eof) {
+        input_.setstate(ios::eofbit);
+        return false;
+    }
+
+    recordLineNumber_ = lineNumber_;
+    malformed_ = false;
+    size_t count = 0;
+    bool endOfRecord = false;
+    while (!endOfRecord) {
+        if (count == fields.size()) {
+            fields.emplace_back();
+        }
+        string &field = fields[count++];
+        field.clear();
+
+        int c = buffer->sbumpc();
+        if (c == '"') {
+            while (true) {
+                c = buffer->sbumpc();
+                if (c == eof) {
+                    malformed_ = true;
+                    break;
+                }
+                if (c == '"') {
+                    if (buffer->sgetc() != '"') {
+                        c = buffer->sbumpc();
+                        break;
+                    }
+                    buffer->sbumpc();
+                } else if (c == '\n') {
+                    ++lineNumber_;
+                }
+                field.push_back(static_cast<char>(c));
+            }
+            while (c != eof && c != delimiter_ && c != '\n') {
+                if (c != '\r') {
+                    malformed_ = true;
+                }
+                c = buffer->sbumpc();
+            }
+        } else {
+            while (c != eof && c != delimiter_ && c != '\n') {
+                field.push_back(static_cast<char>(c));
+                c = buffer->sbumpc();
+            }
+            if (!field.empty() && field.back() == '\r') {
+                field.pop_back();
+            }
+        }
+
+        if (c == '\n') {
+            ++lineNumber_;
+        }
+        endOfRecord = c != delimiter_;
+    }
+    fields.resize(count);
+    return true;
+}
+
+size_t CsvReader::getLineNumber() const { return recordLineNumber_; }
+
+bool CsvReader::isMalformed() const { return malformed_; }
+
+char CsvReader::delimiterForFile(const string &filename) {
+    size_t length = filename.size();
+    if (length >= 4 && (filename.compare(length - 4, 4, ".tsv") == 0 ||
+                        filename.compare(length - 4, 4, ".txt") == 0)) {
+        return '\t';
+    }
+    return ',';
+}
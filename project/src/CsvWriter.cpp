@@ -0,0 +1,62 @@
+#include "../headers/CsvWriter.h"
+#include <charconv>
+#include <cstdio>
+
+using namespace std;
+
+CsvWriter::CsvWriter(ostream &output, char delimiter)
+    : output_(output), delimiter_(delimiter), atRecordStart_(true) {}
+
+CsvWriter &CsvWriter::field(string_view value) {
+    if (!atRecordStart_) {
+        output_.put(delimiter_);
+    }
+    atRecordStart_ = false;
+
+    bool needsQuotes = value.find_first_of("\"\r\n") != string_view::npos ||
+                       value.find(delimiter_) != string_view::npos;
+    if (!needsQuotes) {
+        output_.write(value.data(), static_cast<streamsize>(value.size()));
+        return *this;
+    }
+
+    output_.put('"');
+    for (char c : value) {
+        if (c == '"') {
+            output_.put('"');
+        }
+        output_.put(c);
+    }
+    output_.put('"');
+    return *this;
+}
+
+CsvWriter &CsvWriter::field(int value) {
+    char buffer[16];
+    int length = snprintf(buffer, sizeof(buffer), "%d", value);
+    return field(string_view(buffer, static_cast<size_t>(length)));
+}
+
+CsvWriter &CsvWriter::field(size_t value) {
+    char buffer[24];
+    int length = snprintf(buffer, sizeof(buffer), "%zu", value);
+    return field(string_view(buffer, static_cast<size_t>(length)));
+}
+
+CsvWriter &CsvWriter::field(double value) {
+    char buffer[32];
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+    to_chars_result result = to_chars(buffer, buffer + sizeof(buffer), value);
+    size_t length = static_cast<size_t>(result.ptr - buffer);
+#else
+    size_t length = static_cast<size_t>(snprintf(buffer, sizeof(buffer), "%.17g", value));
+#endif
+    return field(string_view(buffer, length));
+}
+
+void CsvWriter::endRecord() {
+    output_.put('\n');
+    atRecordStart_ = true;
+}
+
+bool CsvWriter::good() const { return static_cast<bool>(output_); }
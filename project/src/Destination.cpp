@@ -1,33 +1,104 @@
 #include "../headers/Destination.h"
+#include <algorithm>
+#include <cmath>
 #include <iomanip>
 #include <sstream>
 
 using namespace std;
 
+double greatCircleDistanceKm(double latitude1, double longitude1,
+                             double latitude2, double longitude2) {
+    const double radiansPerDegree = acos(-1.0) / 180.0;
+    double latitudeDelta = (latitude2 - latitude1) * radiansPerDegree;
+    double longitudeDelta = (longitude2 - longitude1) * radiansPerDegree;
+    double sinLatitude = sin(latitudeDelta / 2.0);
+    double sinLongitude = sin(longitudeDelta / 2.0);
+    double a = sinLatitude * sinLatitude + cos(latitude1 * radiansPerDegree) *
+                                               cos(latitude2 * radiansPerDegree) *
+                                               sinLongitude * sinLongitude;
+    return 2.0 * EARTH_RADIUS_KM * asin(min(1.0, sqrt(a)));
+}
+
 Destination::Destination()
     : code_(""), name_(""), city_(""), country_(""), runwayLengthMeters_(0.0),
-      distanceFromBaseKm_(0.0) {}
+      distanceFromBaseKm_(0.0), hasCoordinates_(false), latitude_(0.0), longitude_(0.0) {}
 
 Destination::Destination(const string &code, const string &name,
                          const string &city, const string &country,
                          double runwayLength, double distance)
     : code_(""), name_(name), city_(city), country_(country),
-      runwayLengthMeters_(0.0), distanceFromBaseKm_(0.0) {
+      runwayLengthMeters_(0.0), distanceFromBaseKm_(0.0), hasCoordinates_(false),
+      latitude_(0.0), longitude_(0.0) {
 
     setCode(code);
     setRunwayLengthMeters(runwayLength);
     setDistanceFromBaseKm(distance);
 }
 
+Destination::Destination(const string &code, const string &name,
+                         const string &city, const string &country,
+                         double runwayLength, double distance, double latitude,
+                         double longitude)
+    : code_(""), name_(name), city_(city), country_(country),
+      runwayLengthMeters_(0.0), distanceFromBaseKm_(0.0), hasCoordinates_(false),
+      latitude_(0.0), longitude_(0.0) {
+
+    setCode(code);
+    setRunwayLengthMeters(runwayLength);
+    setDistanceFromBaseKm(distance);
+    setCoordinates(latitude, longitude);
+}
+
 Destination::Destination(const Destination &other)
     : code_(other.code_), name_(other.name_), city_(other.city_),
       country_(other.country_), runwayLengthMeters_(other.runwayLengthMeters_),
-      distanceFromBaseKm_(other.distanceFromBaseKm_) {}
+      distanceFromBaseKm_(other.distanceFromBaseKm_), hasCoordinates_(other.hasCoordinates_),
+      latitude_(other.latitude_), longitude_(other.longitude_) {}
+
+Destination::Destination(Destination &&other) noexcept
+    : code_(move(other.code_)), name_(move(other.name_)), city_(move(other.city_)),
+      country_(move(other.country_)), runwayLengthMeters_(other.runwayLengthMeters_),
+      distanceFromBaseKm_(other.distanceFromBaseKm_), hasCoordinates_(other.hasCoordinates_),
+      latitude_(other.latitude_), longitude_(other.longitude_) {}
 
 Destination::~Destination() {}
 
+Destination &Destination::operator=(const Destination &other) {
+    if (this == &other) {
+        return *this;
+    }
+    code_ = other.code_;
+    name_ = other.name_;
+    city_ = other.city_;
+    country_ = other.country_;
+    runwayLengthMeters_ = other.runwayLengthMeters_;
+    distanceFromBaseKm_ = other.distanceFromBaseKm_;
+    hasCoordinates_ = other.hasCoordinates_;
+    latitude_ = other.latitude_;
+    longitude_ = other.longitude_;
+    return *this;
+}
+
+Destination &Destination::operator=(Destination &&other) noexcept {
+    if (this == &other) {
+        return *this;
+    }
+    code_ = move(other.code_);
+    name_ = move(other.name_);
+    city_ = move(other.city_);
+    country_ = move(other.country_);
+    runwayLengthMeters_ = other.runwayLengthMeters_;
+    distanceFromBaseKm_ = other.distanceFromBaseKm_;
+    hasCoordinates_ = other.hasCoordinates_;
+    latitude_ = other.latitude_;
+    longitude_ = other.longitude_;
+    return *this;
+}
+
 string Destination::getCode() const { return code_; }
 
+const string &Destination::getCodeRef() const { return code_; }
+
 string Destination::getName() const { return name_; }
 
 string Destination::getCity() const { return city_; }
@@ -42,6 +113,12 @@ double Destination::getDistanceFromBaseKm() const {
     return distanceFromBaseKm_;
 }
 
+bool Destination::hasCoordinates() const { return hasCoordinates_; }
+
+double Destination::getLatitude() const { return latitude_; }
+
+double Destination::getLongitude() const { return longitude_; }
+
 void Destination::setCode(const string &code) {
     if (code.empty()) {
         throw invalid_argument("Кодът на дестинацията не може да е празен");
@@ -69,6 +146,35 @@ void Destination::setDistanceFromBaseKm(double distance) {
     distanceFromBaseKm_ = distance;
 }
 
+void Destination::setCoordinates(double latitude, double longitude) {
+    if (!(latitude >= -90.0 && latitude <= 90.0)) {
+        throw invalid_argument("Географската ширина трябва да е между -90 и 90");
+    }
+    if (!(longitude >= -180.0 && longitude <= 180.0)) {
+        throw invalid_argument("Географската дължина трябва да е между -180 и 180");
+    }
+    latitude_ = latitude;
+    longitude_ = longitude;
+    hasCoordinates_ = true;
+}
+
+void Destination::clearCoordinates() {
+    hasCoordinates_ = false;
+    latitude_ = 0.0;
+    longitude_ = 0.0;
+}
+
+double Destination::distanceToKm(const Destination &other) const {
+    return greatCircleDistanceKm(latitude_, longitude_, other.latitude_, other.longitude_);
+}
+
+double Destination::distanceFromAirportKm(const Destination *airport) const {
+    if (airport == nullptr || !airport->hasCoordinates_ || !hasCoordinates_) {
+        return distanceFromBaseKm_;
+    }
+    return airport->distanceToKm(*this);
+}
+
 string Destination::getDisplayString() const {
     ostringstream oss;
     oss << code_ << " - " << city_;
@@ -87,6 +193,10 @@ ostream &operator<<(ostream &os, const Destination &destination) {
     os << "Дължина на пистата:  " << fixed << setprecision(2)
        << destination.runwayLengthMeters_ << " м" << endl;
     os << "Разстояние от базата: " << destination.distanceFromBaseKm_ << " км" << endl;
+    if (destination.hasCoordinates_) {
+        os << "Координати:          " << setprecision(4) << destination.latitude_ << ", "
+           << destination.longitude_ << endl;
+    }
     return os;
 }
 
@@ -107,6 +217,7 @@ void Destination::displayMenu() {
     cout << "2. Преглед на всички дестинации" << endl;
     cout << "3. Детайли за дестинация" << endl;
     cout << "4. Премахване на дестинация" << endl;
+    cout << "5. Промяна на дължината на пистата" << endl;
     cout << "0. Назад към главното меню" << endl;
     cout << "Въведете избор: ";
 }
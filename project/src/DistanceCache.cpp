@@ -0,0 +1,43 @@
+#include "../headers/DistanceCache.h"
+#include <functional>
+
+using namespace std;
+
+size_t DistanceCache::AirportPairHash::operator()(const AirportPair &airports) const {
+    hash<string> hasher;
+    return hasher(airports.first) * 31 + hasher(airports.second);
+}
+
+DistanceCache::DistanceCache() : distances_() {}
+
+size_t DistanceCache::size() const { return distances_.size(); }
+
+double DistanceCache::getDistanceFromAirportKm(const Destination *airport,
+                                               const Destination &destination) {
+    if (airport == nullptr || !airport->hasCoordinates() || !destination.hasCoordinates()) {
+        return destination.distanceFromAirportKm(airport);
+    }
+    const string &from = airport->getCodeRef();
+    const string &to = destination.getCodeRef();
+    AirportPair key = from < to ? AirportPair(from, to) : AirportPair(to, from);
+    // emplace заделя възел дори когато ключът вече е в кеша.
+    auto found = distances_.find(key);
+    if (found != distances_.end()) {
+        return found->second;
+    }
+    double distance = airport->distanceToKm(destination);
+    distances_.emplace(move(key), distance);
+    return distance;
+}
+
+void DistanceCache::forget(const string &code) {
+    for (auto it = distances_.begin(); it != distances_.end();) {
+        if (it->first.first == code || it->first.second == code) {
+            it = distances_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void DistanceCache::clear() { distances_.clear(); }
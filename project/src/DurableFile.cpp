@@ -0,0 +1,74 @@
+#include "../headers/DurableFile.h"
+#include <cerrno>
+#include <cstdio>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace std;
+
+bool writeFileDurably(const string &path, const char *data, size_t size) {
+    int fd = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        return false;
+    }
+
+    size_t written = 0;
+    while (written < size) {
+        ssize_t result = write(fd, data + written, size - written);
+        if (result < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            close(fd);
+            return false;
+        }
+        written += static_cast<size_t>(result);
+    }
+
+    bool synced = fsync(fd) == 0;
+    return close(fd) == 0 && synced;
+}
+
+bool writeFileDurably(const string &path, const string &contents) {
+    return writeFileDurably(path, contents.data(), contents.size());
+}
+
+bool renameDurably(const string &from, const string &to) {
+    if (rename(from.c_str(), to.c_str()) != 0) {
+        return false;
+    }
+    return syncDirectory(getParentDirectory(to));
+}
+
+bool replaceFileAtomically(const string &path, const string &contents) {
+    string temporaryPath = path + ".tmp";
+    if (!writeFileDurably(temporaryPath, contents)) {
+        remove(temporaryPath.c_str());
+        return false;
+    }
+    return renameDurably(temporaryPath, path);
+}
+
+bool syncDirectory(const string &directory) {
+    int fd = open(directory.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    bool synced = fsync(fd) == 0;
+    close(fd);
+    return synced;
+}
+
+string getParentDirectory(const string &path) {
+    size_t slash = path.find_last_of('/');
+    if (slash == string::npos) {
+        return ".";
+    }
+    return slash == 0 ? "/" : path.substr(0, slash);
+}
+
+bool fileExists(const string &path) {
+    struct stat info;
+    return stat(path.c_str(), &info) == 0;
+}
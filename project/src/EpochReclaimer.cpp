@@ -0,0 +1,133 @@
+#include "../headers/EpochReclaimer.h"
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+using namespace std;
+
+namespace {
+
+const int MAX_READER_SLOTS = 128;
+const int NO_SLOT = -1;
+
+struct alignas(64) ReaderSlot {
+    atomic<uint64_t> epoch;
+    atomic<bool> inUse;
+};
+
+struct RetiredObject {
+    const void *object;
+    void (*deleter)(const void *);
+    uint64_t epoch;
+};
+
+ReaderSlot readerSlots[MAX_READER_SLOTS];
+atomic<uint64_t> globalEpoch(1);
+atomic<size_t> readersWithoutSlot(0);
+mutex retiredMutex;
+vector<RetiredObject> retiredObjects;
+
+// Всяка нишка заема слот при първото си четене и го освобождава при края
+// си. Вложените Guard-ове в една нишка използват външния.
+struct ThreadReader {
+    int slot;
+    int depth;
+
+    ThreadReader() : slot(NO_SLOT), depth(0) {}
+    ~ThreadReader() {
+        if (slot != NO_SLOT) {
+            readerSlots[slot].epoch.store(0);
+            readerSlots[slot].inUse.store(false);
+        }
+    }
+};
+
+thread_local ThreadReader threadReader;
+
+int acquireSlot() {
+    for (int i = 0; i < MAX_READER_SLOTS; ++i) {
+        bool expected = false;
+        if (!readerSlots[i].inUse.load(memory_order_relaxed) &&
+            readerSlots[i].inUse.compare_exchange_strong(expected, true)) {
+            return i;
+        }
+    }
+    return NO_SLOT;
+}
+
+size_t reclaimLocked() {
+    // Читател без слот може да държи коя да е версия, затова докато има
+    // такъв, нищо не се освобождава.
+    if (readersWithoutSlot.load() != 0) {
+        return 0;
+    }
+    uint64_t oldestActive = UINT64_MAX;
+    for (const auto &slot : readerSlots) {
+        uint64_t epoch = slot.epoch.load();
+        if (epoch != 0 && epoch < oldestActive) {
+            oldestActive = epoch;
+        }
+    }
+
+    size_t freed = 0;
+    size_t kept = 0;
+    for (const auto &retired : retiredObjects) {
+        if (retired.epoch <= oldestActive) {
+            retired.deleter(retired.object);
+            ++freed;
+        } else {
+            retiredObjects[kept++] = retired;
+        }
+    }
+    retiredObjects.resize(kept);
+    return freed;
+}
+
+}
+
+EpochReclaimer::Guard::Guard() : slot_(NO_SLOT) {
+    ThreadReader &reader = threadReader;
+    if (reader.depth++ > 0) {
+        slot_ = reader.slot;
+        return;
+    }
+    if (reader.slot == NO_SLOT) {
+        reader.slot = acquireSlot();
+    }
+    slot_ = reader.slot;
+    if (slot_ == NO_SLOT) {
+        readersWithoutSlot.fetch_add(1);
+        return;
+    }
+    readerSlots[slot_].epoch.store(globalEpoch.load());
+}
+
+EpochReclaimer::Guard::~Guard() {
+    ThreadReader &reader = threadReader;
+    if (--reader.depth > 0) {
+        return;
+    }
+    if (slot_ == NO_SLOT) {
+        readersWithoutSlot.fetch_sub(1);
+        return;
+    }
+    readerSlots[slot_].epoch.store(0, memory_order_release);
+}
+
+void EpochReclaimer::retire(const void *object, void (*deleter)(const void *)) {
+    lock_guard<mutex> lock(retiredMutex);
+    uint64_t epoch = globalEpoch.fetch_add(1) + 1;
+    retiredObjects.push_back(RetiredObject{object, deleter, epoch});
+    reclaimLocked();
+}
+
+size_t EpochReclaimer::reclaim() {
+    lock_guard<mutex> lock(retiredMutex);
+    return reclaimLocked();
+}
+
+size_t EpochReclaimer::getPendingCount() {
+    lock_guard<mutex> lock(retiredMutex);
+    return retiredObjects.size();
+}
@@ -0,0 +1,202 @@
+#include "../headers/FleetAssignment.h"
+#include "../headers/MinCostFlow.h"
+#include <algorithm>
+#include <cmath>
+#include <map>
+
+using namespace std;
+
+namespace {
+
+// Кандидат за маршрут е група самолети от един клас с обща база; цената е
+// за разстоянието от тази база.
+struct Candidate {
+    int64_t cost;
+    uint32_t group;
+    size_t airplaneCount;
+};
+
+bool cheaperCandidate(const Candidate &left, const Candidate &right) {
+    return left.cost != right.cost ? left.cost < right.cost : left.group < right.group;
+}
+
+// Цените в мрежата са в цели центове, за да са точни сумите по пътищата.
+int64_t costInCents(double cost) { return llround(cost * 100.0); }
+
+}
+
+FleetAssignmentOptimizer::FleetAssignmentOptimizer(const vector<Airplane> &airplanes,
+                                                   const vector<SlotHandle<Airplane> > &handles)
+    : groups_(), baseAirportCodes_(), baseAirportIds_(), classCount_(0) {
+    map<const PlaneClass *, uint32_t> classPositions;
+    map<pair<uint32_t, uint32_t>, uint32_t> groupPositions;
+    for (size_t i = 0; i < airplanes.size(); ++i) {
+        const Airplane &airplane = airplanes[i];
+        if (!airplane.isOperational()) {
+            continue;
+        }
+        uint32_t planeClass =
+            classPositions
+                .emplace(airplane.getSharedPlaneClass().get(),
+                         static_cast<uint32_t>(classPositions.size()))
+                .first->second;
+        const string &baseCode = airplane.getBaseAirportCodeRef();
+        auto base = baseAirportIds_.find(baseCode);
+        if (base == baseAirportIds_.end()) {
+            uint32_t id = static_cast<uint32_t>(baseAirportCodes_.size());
+            base = baseAirportIds_.emplace(baseCode, id).first;
+            baseAirportCodes_.push_back(baseCode);
+        }
+        auto insertedGroup = groupPositions.emplace(make_pair(planeClass, base->second),
+                                                    static_cast<uint32_t>(groups_.size()));
+        if (insertedGroup.second) {
+            groups_.push_back(
+                AirplaneGroup{airplane, base->second, vector<SlotHandle<Airplane> >()});
+        }
+        groups_[insertedGroup.first->second].members.push_back(handles[i]);
+    }
+    classCount_ = classPositions.size();
+}
+
+size_t FleetAssignmentOptimizer::getClassCount() const { return classCount_; }
+
+size_t FleetAssignmentOptimizer::getGroupCount() const { return groups_.size(); }
+
+const vector<string> &FleetAssignmentOptimizer::getBaseAirportCodes() const {
+    return baseAirportCodes_;
+}
+
+FleetAssignment FleetAssignmentOptimizer::assign(const vector<const Destination *> &destinations,
+                                                 const vector<RouteRequest> &routes,
+                                                 const vector<double> &baseDistances) const {
+    size_t routeCount = routes.size();
+    size_t groupCount = groups_.size();
+    size_t baseAirportCount = baseAirportCodes_.size();
+    FleetAssignment result;
+    result.routes.resize(routeCount);
+    result.assignedRoutes = 0;
+    result.totalCost = 0.0;
+
+    vector<vector<Candidate> > candidates(routeCount);
+    size_t feasibleRoutes = 0;
+    for (size_t route = 0; route < routeCount; ++route) {
+        RouteAssignment &assignment = result.routes[route];
+        assignment.compatibleAirplanes = 0;
+        assignment.selected = RouteCost{SlotHandle<Airplane>(), 0.0, 0.0, 0.0};
+        const Destination *destination = destinations[route];
+        int passengers = routes[route].passengers;
+        if (destination == nullptr) {
+            assignment.status = ROUTE_UNKNOWN_DESTINATION;
+            continue;
+        }
+        if (passengers < 0) {
+            assignment.status = ROUTE_INVALID_LOAD;
+            continue;
+        }
+
+        // Летище на излитане, което не е база на изправен самолет, не
+        // допуска нито една група.
+        const string &origin = routes[route].originAirportCode;
+        auto originBase = baseAirportIds_.find(origin);
+        bool anyBase = origin.empty();
+        bool knownOrigin = originBase != baseAirportIds_.end();
+        double runwayLength = destination->getRunwayLengthMeters();
+        const double *distances = baseDistances.data() + route * baseAirportCount;
+        for (size_t group = 0; group < groupCount; ++group) {
+            const AirplaneGroup &pool = groups_[group];
+            if (!anyBase && !(knownOrigin && pool.baseAirport == originBase->second)) {
+                continue;
+            }
+            const Airplane &airplane = pool.representative;
+            double distance = distances[pool.baseAirport];
+            if (passengers > airplane.getPlaneClassRef().getSeatCount() ||
+                !airplane.canFlyToDestination(runwayLength, distance)) {
+                continue;
+            }
+            candidates[route].push_back(
+                Candidate{costInCents(airplane.calculateOperatingCost(distance, passengers)),
+                          static_cast<uint32_t>(group), pool.members.size()});
+            assignment.compatibleAirplanes += pool.members.size();
+        }
+        assignment.status = candidates[route].empty() ? ROUTE_NO_AIRPLANE : ROUTE_FLEET_EXHAUSTED;
+        feasibleRoutes += candidates[route].empty() ? 0 : 1;
+    }
+
+    // Оптималното решение използва най-много feasibleRoutes самолета, затова
+    // за всеки маршрут стигат най-евтините кандидати, които ги съдържат: ако
+    // маршрутът получи по-скъп самолет, един от по-евтините остава свободен.
+    // Маршрут без самолет струва повече от всички избрани ребра заедно, така
+    // че първо се покриват колкото може повече маршрути.
+    int64_t unassignedCost = 1;
+    for (auto &routeCandidates : candidates) {
+        sort(routeCandidates.begin(), routeCandidates.end(), cheaperCandidate);
+        size_t covered = 0;
+        size_t kept = 0;
+        while (kept < routeCandidates.size() && covered < feasibleRoutes) {
+            covered += routeCandidates[kept].airplaneCount;
+            ++kept;
+        }
+        routeCandidates.resize(kept);
+        if (kept > 0) {
+            unassignedCost += routeCandidates.back().cost;
+        }
+    }
+
+    size_t firstGroupNode = routeCount;
+    size_t unassignedNode = firstGroupNode + groupCount;
+    size_t sink = unassignedNode + 1;
+    MinCostFlow flow(sink + 1);
+    vector<vector<size_t> > candidateEdges(routeCount);
+    for (size_t route = 0; route < routeCount; ++route) {
+        for (const auto &candidate : candidates[route]) {
+            candidateEdges[route].push_back(
+                flow.addEdge(route, firstGroupNode + candidate.group, 1, candidate.cost));
+        }
+        if (!candidates[route].empty()) {
+            flow.addEdge(route, unassignedNode, 1, unassignedCost);
+        }
+    }
+    for (size_t group = 0; group < groupCount; ++group) {
+        flow.addEdge(firstGroupNode + group, sink,
+                     static_cast<int32_t>(groups_[group].members.size()), 0);
+    }
+    flow.addEdge(unassignedNode, sink, static_cast<int32_t>(feasibleRoutes), 0);
+
+    for (size_t route = 0; route < routeCount; ++route) {
+        int64_t pathCost;
+        if (!candidates[route].empty()) {
+            flow.augment(route, sink, pathCost);
+        }
+    }
+
+    // Потокът казва само от коя група е самолетът на всеки маршрут;
+    // конкретните самолети се раздават по реда в групата.
+    vector<size_t> nextMember(groupCount, 0);
+    for (size_t route = 0; route < routeCount; ++route) {
+        for (size_t i = 0; i < candidates[route].size(); ++i) {
+            if (flow.getFlow(candidateEdges[route][i]) == 0) {
+                continue;
+            }
+            uint32_t group = candidates[route][i].group;
+            const AirplaneGroup &pool = groups_[group];
+            double distance = baseDistances[route * baseAirportCount + pool.baseAirport];
+            int passengers = routes[route].passengers;
+            const PlaneClass &planeClass = pool.representative.getPlaneClassRef();
+
+            RouteAssignment &assignment = result.routes[route];
+            assignment.status = ROUTE_ASSIGNED;
+            assignment.selected.airplane = pool.members[nextMember[group]++];
+            assignment.selected.fuelLiters =
+                planeClass.calculateFuelConsumption(distance, passengers);
+            assignment.selected.flightHours = planeClass.getAverageSpeedKmh() > 0.0
+                                                  ? distance / planeClass.getAverageSpeedKmh()
+                                                  : 0.0;
+            assignment.selected.cost =
+                pool.representative.calculateOperatingCost(distance, passengers);
+            ++result.assignedRoutes;
+            result.totalCost += assignment.selected.cost;
+            break;
+        }
+    }
+    return result;
+}
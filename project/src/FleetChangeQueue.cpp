@@ -0,0 +1,54 @@
+#include "../headers/FleetChangeQueue.h"
+
+using namespace std;
+
+namespace {
+
+size_t roundUpToPowerOfTwo(size_t value) {
+    size_t result = 1;
+    while (result < value) {
+        result <<= 1;
+    }
+    return result;
+}
+
+}
+
+FleetChangeQueue::FleetChangeQueue(size_t capacity)
+    : slots_(roundUpToPowerOfTwo(capacity == 0 ? 1 : capacity)), mask_(slots_.size() - 1),
+      head_(0), tail_(0), overflowed_(false) {}
+
+size_t FleetChangeQueue::capacity() const { return slots_.size(); }
+
+size_t FleetChangeQueue::size() const {
+    return tail_.load(memory_order_acquire) - head_.load(memory_order_acquire);
+}
+
+size_t FleetChangeQueue::push(const vector<FleetChange> &changes) {
+    size_t tail = tail_.load(memory_order_relaxed);
+    size_t freeSlots = slots_.size() - (tail - head_.load(memory_order_acquire));
+    size_t count = changes.size() < freeSlots ? changes.size() : freeSlots;
+    for (size_t i = 0; i < count; ++i) {
+        slots_[(tail + i) & mask_] = changes[i];
+    }
+    if (count < changes.size()) {
+        overflowed_.store(true, memory_order_release);
+    }
+    tail_.store(tail + count, memory_order_release);
+    return count;
+}
+
+size_t FleetChangeQueue::poll(vector<FleetChange> &changes, size_t maxCount) {
+    size_t head = head_.load(memory_order_relaxed);
+    size_t available = tail_.load(memory_order_acquire) - head;
+    size_t count = available < maxCount ? available : maxCount;
+    for (size_t i = 0; i < count; ++i) {
+        changes.push_back(move(slots_[(head + i) & mask_]));
+    }
+    head_.store(head + count, memory_order_release);
+    return count;
+}
+
+bool FleetChangeQueue::takeOverflow() {
+    return overflowed_.exchange(false, memory_order_acq_rel);
+}
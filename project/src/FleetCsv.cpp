@@ -0,0 +1,485 @@
+#include "../headers/FleetCsv.h"
+#include "../headers/CsvReader.h"
+#include "../headers/CsvWriter.h"
+#include "../headers/RecordReader.h"
+#include <fstream>
+#include <unordered_set>
+
+using namespace std;
+
+namespace {
+
+const vector<string> PLANE_CLASS_COLUMNS = {"manufacturer", "model", "seats",
+                                            "min_runway", "fuel_per_km_seat", "tank_liters",
+                                            "speed_kmh", "crew"};
+const vector<string> AIRPLANE_COLUMNS = {"id", "plane_class", "operational", "base_airport",
+                                         "flight_hours"};
+const vector<string> DESTINATION_COLUMNS = {"code",     "name",        "city",
+                                            "country",  "runway_m",    "distance_km",
+                                            "latitude", "longitude"};
+// Файловете отпреди координатите нямат последните две колони.
+const size_t DESTINATION_REQUIRED_COLUMNS = 6;
+const vector<string> ROUTE_COLUMNS = {"code", "passengers"};
+const vector<string> ROUTE_ORIGIN_COLUMNS = {"code", "passengers", "origin"};
+const vector<string> ROUTE_ASSIGNMENT_COLUMNS = {"code", "passengers", "status",
+                                                 "airplane", "fuel_liters", "flight_hours",
+                                                 "cost", "compatible"};
+
+const char *routeStatusName(RouteStatus status) {
+    switch (status) {
+        case ROUTE_ASSIGNED:
+            return "assigned";
+        case ROUTE_UNKNOWN_DESTINATION:
+            return "unknown_destination";
+        case ROUTE_INVALID_LOAD:
+            return "invalid_load";
+        case ROUTE_NO_AIRPLANE:
+            return "no_airplane";
+        case ROUTE_FLEET_EXHAUSTED:
+            return "fleet_exhausted";
+    }
+    return "";
+}
+
+void writeHeader(CsvWriter &writer, const vector<string> &columns) {
+    for (const auto &column : columns) {
+        writer.field(column);
+    }
+    writer.endRecord();
+}
+
+void writeReject(ostream *rejects, size_t lineNumber, const string &reason,
+                 const vector<string> &fields) {
+    if (rejects == nullptr) {
+        return;
+    }
+    CsvWriter writer(*rejects, ',');
+    writer.field(lineNumber).field(reason);
+    for (const auto &field : fields) {
+        writer.field(field);
+    }
+    writer.endRecord();
+}
+
+bool readRoutesFile(const string &filename, vector<RouteRequest> &routes) {
+    ifstream input(filename, ios::binary);
+    if (!input.is_open()) {
+        return false;
+    }
+    routes = FleetCsv::readRouteRequests(input, CsvReader::delimiterForFile(filename));
+    return !input.bad();
+}
+
+void writeRouteAssignments(const FleetManager &manager, const vector<RouteRequest> &routes,
+                           const vector<RouteAssignment> &assignments, ostream &output,
+                           char delimiter) {
+    CsvWriter writer(output, delimiter);
+    writeHeader(writer, ROUTE_ASSIGNMENT_COLUMNS);
+    for (size_t i = 0; i < routes.size(); ++i) {
+        FleetCsv::writeRouteAssignment(writer, manager, routes[i], assignments[i]);
+    }
+}
+
+// Текстовите файлове и журналът разделят полетата с табулация и записите
+// с нов ред, затова такива символи не се допускат в стойностите. Интервалите
+// са позволени: модел като "737 MAX 8" се запазва и зарежда отново, защото
+// и plane_classes.txt е с табулации.
+bool containsControlCharacters(const vector<string> &fields) {
+    for (const auto &field : fields) {
+        if (field.find_first_of("\t\r\n") != string::npos) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Общата част на трите вида импорт: чете записите, пропуска заглавния ред,
+// проверява за дубликати спрямо флота и текущата партида и добавя партидата
+// наведнъж, когато се напълни. Колоните след requiredColumns не са
+// задължителни, но ако ги има, трябва да са всички.
+template <typename Record, typename ParseRecord, typename ExistsInFleet, typename AddBatch>
+ImportSummary importRecords(istream &input, char delimiter, ostream *rejects,
+                            const vector<string> &columns, size_t requiredColumns,
+                            size_t batchSize, ParseRecord parseRecord,
+                            ExistsInFleet existsInFleet, AddBatch addBatch) {
+    ImportSummary summary = {0, 0, 0};
+    CsvReader reader(input, delimiter);
+    vector<string> fields;
+    vector<Record> batch;
+    unordered_set<string> batchKeys;
+    batch.reserve(batchSize);
+
+    auto flush = [&]() {
+        summary.imported += addBatch(batch);
+        batch.clear();
+        batchKeys.clear();
+    };
+
+    bool firstRecord = true;
+    while (reader.nextRecord(fields)) {
+        if (firstRecord) {
+            firstRecord = false;
+            if (fields == columns ||
+                fields == vector<string>(columns.begin(), columns.begin() + requiredColumns)) {
+                continue;
+            }
+        }
+
+        if (reader.isMalformed()) {
+            writeReject(rejects, reader.getLineNumber(), "незатворени кавички", fields);
+            ++summary.rejected;
+            continue;
+        }
+        if (fields.size() != columns.size() && fields.size() != requiredColumns) {
+            writeReject(rejects, reader.getLineNumber(),
+                        "очаквани " + to_string(columns.size()) + " полета", fields);
+            ++summary.rejected;
+            continue;
+        }
+
+        if (containsControlCharacters(fields)) {
+            writeReject(rejects, reader.getLineNumber(), "непозволен символ в поле", fields);
+            ++summary.rejected;
+            continue;
+        }
+
+        string key;
+        string reason;
+        try {
+            if (!parseRecord(fields, batch, key, reason)) {
+                writeReject(rejects, reader.getLineNumber(), reason, fields);
+                ++summary.rejected;
+                continue;
+            }
+        } catch (const exception &e) {
+            writeReject(rejects, reader.getLineNumber(), e.what(), fields);
+            ++summary.rejected;
+            continue;
+        }
+
+        if (existsInFleet(key) || !batchKeys.insert(key).second) {
+            batch.pop_back();
+            writeReject(rejects, reader.getLineNumber(), "дублиран запис", fields);
+            ++summary.duplicates;
+            continue;
+        }
+        if (batch.size() >= batchSize) {
+            flush();
+        }
+    }
+    flush();
+    return summary;
+}
+
+bool parseNumber(const string &text, int &value) { return RecordReader::parseInt(text, value); }
+
+bool parseNumber(const string &text, double &value) {
+    return RecordReader::parseDouble(text, value);
+}
+
+}
+
+ImportSummary FleetCsv::importPlaneClasses(FleetManager &manager, istream &input, char delimiter,
+                                           ostream *rejects, size_t batchSize) {
+    auto parseRecord = [](const vector<string> &fields, vector<PlaneClass> &batch, string &key,
+                          string &reason) {
+        int seatCount, crewCount;
+        double minRunway, fuelConsumption, tankVolume, avgSpeed;
+        if (!parseNumber(fields[2], seatCount) || !parseNumber(fields[3], minRunway) ||
+            !parseNumber(fields[4], fuelConsumption) || !parseNumber(fields[5], tankVolume) ||
+            !parseNumber(fields[6], avgSpeed) || !parseNumber(fields[7], crewCount)) {
+            reason = "невалидно число";
+            return false;
+        }
+        batch.emplace_back(fields[0], fields[1], seatCount, minRunway, fuelConsumption,
+                           tankVolume, avgSpeed, crewCount);
+        key = batch.back().getClassIdRef();
+        return true;
+    };
+    auto existsInFleet = [&manager](const string &key) {
+        return !manager.findPlaneClassHandleById(key).isNull();
+    };
+    auto addBatch = [&manager](const vector<PlaneClass> &batch) {
+        return manager.addPlaneClasses(batch);
+    };
+    return importRecords<PlaneClass>(input, delimiter, rejects, PLANE_CLASS_COLUMNS,
+                                     PLANE_CLASS_COLUMNS.size(), batchSize, parseRecord,
+                                     existsInFleet, addBatch);
+}
+
+ImportSummary FleetCsv::importAirplanes(FleetManager &manager, istream &input, char delimiter,
+                                        ostream *rejects, size_t batchSize) {
+    auto parseRecord = [&manager](const vector<string> &fields, vector<Airplane> &batch,
+                                  string &key, string &reason) {
+        shared_ptr<const PlaneClass> planeClass =
+            manager.getSharedPlaneClass(manager.findPlaneClassHandleById(fields[1]));
+        if (!planeClass) {
+            reason = "непознат клас самолет";
+            return false;
+        }
+        int operational, flightHours;
+        if (!parseNumber(fields[2], operational) || (operational != 0 && operational != 1) ||
+            !parseNumber(fields[4], flightHours)) {
+            reason = "невалидно число";
+            return false;
+        }
+        batch.emplace_back(fields[0], planeClass, operational == 1, fields[3], flightHours);
+        key = fields[0];
+        return true;
+    };
+    auto existsInFleet = [&manager](const string &key) {
+        return !manager.findAirplaneHandleById(key).isNull();
+    };
+    auto addBatch = [&manager](const vector<Airplane> &batch) {
+        return manager.addAirplanes(batch);
+    };
+    return importRecords<Airplane>(input, delimiter, rejects, AIRPLANE_COLUMNS,
+                                   AIRPLANE_COLUMNS.size(), batchSize, parseRecord,
+                                   existsInFleet, addBatch);
+}
+
+ImportSummary FleetCsv::importDestinations(FleetManager &manager, istream &input,
+                                           char delimiter, ostream *rejects, size_t batchSize) {
+    auto parseRecord = [](const vector<string> &fields, vector<Destination> &batch, string &key,
+                          string &reason) {
+        double runwayLength, distance, latitude, longitude;
+        if (!parseNumber(fields[4], runwayLength) || !parseNumber(fields[5], distance)) {
+            reason = "невалидно число";
+            return false;
+        }
+        // Празни координати означават, че дестинацията няма такива.
+        bool withCoordinates = fields.size() > DESTINATION_REQUIRED_COLUMNS &&
+                               !(fields[6].empty() && fields[7].empty());
+        if (withCoordinates &&
+            (!parseNumber(fields[6], latitude) || !parseNumber(fields[7], longitude))) {
+            reason = "невалидни координати";
+            return false;
+        }
+        if (withCoordinates) {
+            batch.emplace_back(fields[0], fields[1], fields[2], fields[3], runwayLength, distance,
+                               latitude, longitude);
+        } else {
+            batch.emplace_back(fields[0], fields[1], fields[2], fields[3], runwayLength,
+                               distance);
+        }
+        key = fields[0];
+        return true;
+    };
+    auto existsInFleet = [&manager](const string &key) {
+        return !manager.findDestinationHandleByCode(key).isNull();
+    };
+    auto addBatch = [&manager](const vector<Destination> &batch) {
+        return manager.addDestinations(batch);
+    };
+    return importRecords<Destination>(input, delimiter, rejects, DESTINATION_COLUMNS,
+                                      DESTINATION_REQUIRED_COLUMNS, batchSize, parseRecord,
+                                      existsInFleet, addBatch);
+}
+
+bool FleetCsv::importFile(FleetManager &manager, const string &kind, const string &filename,
+                          const string &rejectsFilename, ImportSummary &summary) {
+    ifstream input(filename, ios::binary);
+    if (!input.is_open()) {
+        return false;
+    }
+    ofstream rejects;
+    if (!rejectsFilename.empty()) {
+        rejects.open(rejectsFilename, ios::binary | ios::trunc);
+        if (!rejects.is_open()) {
+            return false;
+        }
+    }
+    ostream *rejectsStream = rejects.is_open() ? &rejects : nullptr;
+    char delimiter = CsvReader::delimiterForFile(filename);
+
+    if (kind == "classes") {
+        summary = importPlaneClasses(manager, input, delimiter, rejectsStream);
+    } else if (kind == "airplanes") {
+        summary = importAirplanes(manager, input, delimiter, rejectsStream);
+    } else if (kind == "destinations") {
+        summary = importDestinations(manager, input, delimiter, rejectsStream);
+    } else {
+        return false;
+    }
+    return !input.bad() && (rejectsStream == nullptr || static_cast<bool>(rejects));
+}
+
+void FleetCsv::writePlaneClass(CsvWriter &writer, const PlaneClass &planeClass) {
+    writer.field(planeClass.getManufacturer())
+        .field(planeClass.getModel())
+        .field(planeClass.getSeatCount())
+        .field(planeClass.getMinRunwayLength())
+        .field(planeClass.getFuelConsumptionPerKmPerSeat())
+        .field(planeClass.getTankVolumeLiters())
+        .field(planeClass.getAverageSpeedKmh())
+        .field(planeClass.getRequiredCrewCount());
+    writer.endRecord();
+}
+
+void FleetCsv::writeAirplane(CsvWriter &writer, const Airplane &airplane) {
+    writer.field(airplane.getIdentificationNumberRef())
+        .field(airplane.getPlaneClassRef().getClassIdRef())
+        .field(airplane.isOperational() ? 1 : 0)
+        .field(airplane.getBaseAirportCodeRef())
+        .field(airplane.getTotalFlightHours());
+    writer.endRecord();
+}
+
+void FleetCsv::writeDestination(CsvWriter &writer, const Destination &destination) {
+    writer.field(destination.getCodeRef())
+        .field(destination.getName())
+        .field(destination.getCity())
+        .field(destination.getCountry())
+        .field(destination.getRunwayLengthMeters())
+        .field(destination.getDistanceFromBaseKm());
+    if (destination.hasCoordinates()) {
+        writer.field(destination.getLatitude()).field(destination.getLongitude());
+    } else {
+        writer.field(string()).field(string());
+    }
+    writer.endRecord();
+}
+
+void FleetCsv::exportPlaneClasses(const FleetManager &manager, ostream &output, char delimiter) {
+    CsvWriter writer(output, delimiter);
+    writeHeader(writer, PLANE_CLASS_COLUMNS);
+    for (const auto &planeClass : manager.getPlaneClasses()) {
+        writePlaneClass(writer, *planeClass);
+    }
+}
+
+void FleetCsv::exportAirplanes(const FleetManager &manager, ostream &output, char delimiter) {
+    CsvWriter writer(output, delimiter);
+    writeHeader(writer, AIRPLANE_COLUMNS);
+    for (const auto &airplane : manager.getAirplanes()) {
+        writeAirplane(writer, airplane);
+    }
+}
+
+void FleetCsv::exportAirplanes(const FleetManager &manager, const vector<AirplaneHandle> &handles,
+                               ostream &output, char delimiter) {
+    CsvWriter writer(output, delimiter);
+    writeHeader(writer, AIRPLANE_COLUMNS);
+    for (AirplaneHandle handle : handles) {
+        const Airplane *airplane = manager.getAirplane(handle);
+        if (airplane != nullptr) {
+            writeAirplane(writer, *airplane);
+        }
+    }
+}
+
+void FleetCsv::exportDestinations(const FleetManager &manager, ostream &output, char delimiter) {
+    CsvWriter writer(output, delimiter);
+    writeHeader(writer, DESTINATION_COLUMNS);
+    for (const auto &destination : manager.getDestinations()) {
+        writeDestination(writer, destination);
+    }
+}
+
+bool FleetCsv::exportFile(const FleetManager &manager, const string &kind,
+                          const string &filename) {
+    ofstream output(filename, ios::binary | ios::trunc);
+    if (!output.is_open()) {
+        return false;
+    }
+    char delimiter = CsvReader::delimiterForFile(filename);
+
+    if (kind == "classes") {
+        exportPlaneClasses(manager, output, delimiter);
+    } else if (kind == "airplanes") {
+        exportAirplanes(manager, output, delimiter);
+    } else if (kind == "destinations") {
+        exportDestinations(manager, output, delimiter);
+    } else {
+        return false;
+    }
+    output.flush();
+    return static_cast<bool>(output);
+}
+
+bool FleetCsv::exportCompatibleAirplanes(const FleetManager &manager, double runwayLength,
+                                         double distance, const string &filename) {
+    ofstream output(filename, ios::binary | ios::trunc);
+    if (!output.is_open()) {
+        return false;
+    }
+    exportAirplanes(manager, manager.findCompatibleAirplaneHandles(runwayLength, distance),
+                    output, CsvReader::delimiterForFile(filename));
+    output.flush();
+    return static_cast<bool>(output);
+}
+
+void FleetCsv::writeRouteAssignment(CsvWriter &writer, const FleetManager &manager,
+                                    const RouteRequest &route,
+                                    const RouteAssignment &assignment) {
+    const Airplane *airplane = manager.getAirplane(assignment.selected.airplane);
+    writer.field(route.destinationCode)
+        .field(route.passengers)
+        .field(routeStatusName(assignment.status))
+        .field(airplane == nullptr ? string() : airplane->getIdentificationNumberRef())
+        .field(assignment.selected.fuelLiters)
+        .field(assignment.selected.flightHours)
+        .field(assignment.selected.cost)
+        .field(assignment.compatibleAirplanes);
+    writer.endRecord();
+}
+
+// Редове с невалиден брой пътници не се отхвърлят, а получават
+// отрицателно натоварване, за да се върнат в резултата като invalid_load
+// на същата позиция. Третата колона с летище на излитане не е задължителна.
+vector<RouteRequest> FleetCsv::readRouteRequests(istream &input, char delimiter) {
+    vector<RouteRequest> routes;
+    CsvReader reader(input, delimiter);
+    vector<string> fields;
+    bool firstRecord = true;
+    while (reader.nextRecord(fields)) {
+        if (firstRecord) {
+            firstRecord = false;
+            if (fields == ROUTE_COLUMNS || fields == ROUTE_ORIGIN_COLUMNS) {
+                continue;
+            }
+        }
+        bool knownLayout =
+            fields.size() == ROUTE_COLUMNS.size() || fields.size() == ROUTE_ORIGIN_COLUMNS.size();
+        int passengers;
+        if (reader.isMalformed() || !knownLayout || !RecordReader::parseInt(fields[1], passengers)) {
+            passengers = -1;
+        }
+        routes.push_back(RouteRequest{fields.empty() ? string() : fields[0], passengers,
+                                      fields.size() > 2 ? fields[2] : string()});
+    }
+    return routes;
+}
+
+bool FleetCsv::planRoutesFile(const FleetManager &manager, const string &routesFilename,
+                              const string &resultFilename) {
+    vector<RouteRequest> routes;
+    if (!readRoutesFile(routesFilename, routes)) {
+        return false;
+    }
+    ofstream output(resultFilename, ios::binary | ios::trunc);
+    if (!output.is_open()) {
+        return false;
+    }
+    writeRouteAssignments(manager, routes, manager.planRoutes(routes), output,
+                          CsvReader::delimiterForFile(resultFilename));
+    output.flush();
+    return static_cast<bool>(output);
+}
+
+bool FleetCsv::assignRoutesFile(const FleetManager &manager, const string &routesFilename,
+                                const string &resultFilename, FleetAssignment &assignment) {
+    vector<RouteRequest> routes;
+    if (!readRoutesFile(routesFilename, routes)) {
+        return false;
+    }
+    ofstream output(resultFilename, ios::binary | ios::trunc);
+    if (!output.is_open()) {
+        return false;
+    }
+    assignment = manager.assignFleet(routes);
+    writeRouteAssignments(manager, routes, assignment.routes, output,
+                          CsvReader::delimiterForFile(resultFilename));
+    output.flush();
+    return static_cast<bool>(output);
+}
@@ -0,0 +1,197 @@
+#include "../headers/FleetJournal.h"
+#include <iterator>
+#include <sstream>
+
+using namespace std;
+
+namespace {
+
+const string GENERATION_PREFIX = "#generation ";
+const string BATCH_BEGIN_PREFIX = "#begin ";
+const string BATCH_COMMIT = "#commit";
+
+}
+
+FleetJournal::FleetJournal(const string &filename)
+    : filename_(filename), file_(), recordCount_(0), autoFlush_(true), generation_(0) {}
+
+FleetJournal::~FleetJournal() {
+    if (file_.is_open()) {
+        file_.close();
+    }
+}
+
+bool FleetJournal::open(unsigned long generation) {
+    vector<string> existing;
+    vector<size_t> lineNumbers;
+    unsigned long existingGeneration = 0;
+    bool truncated = false;
+    if (!readRecords(filename_, existingGeneration, existing, lineNumbers, truncated) ||
+        existingGeneration != generation) {
+        return reset(generation);
+    }
+    generation_ = generation;
+    if (truncated) {
+        // Иначе следващият запис би се залепил за прекъснатия ред.
+        return rewrite(existing);
+    }
+    recordCount_ = existing.size();
+    file_.open(filename_, ios::app);
+    return file_.is_open();
+}
+
+bool FleetJournal::append(const string &record) {
+    if (!file_.is_open()) {
+        return false;
+    }
+    file_ << record << '\n';
+    if (autoFlush_) {
+        file_.flush();
+    }
+    ++recordCount_;
+    return static_cast<bool>(file_);
+}
+
+bool FleetJournal::appendBatch(const vector<string> &records) {
+    if (!file_.is_open()) {
+        return false;
+    }
+    if (records.empty()) {
+        return true;
+    }
+    file_ << BATCH_BEGIN_PREFIX << records.size() << '\n';
+    for (const auto &record : records) {
+        file_ << record << '\n';
+    }
+    file_ << BATCH_COMMIT << '\n';
+    if (autoFlush_) {
+        file_.flush();
+    }
+    recordCount_ += records.size();
+    return static_cast<bool>(file_);
+}
+
+bool FleetJournal::reset(unsigned long generation) {
+    generation_ = generation;
+    return rewrite(vector<string>());
+}
+
+bool FleetJournal::rewrite(const vector<string> &records) {
+    if (file_.is_open()) {
+        file_.close();
+    }
+    file_.open(filename_, ios::trunc);
+    recordCount_ = 0;
+    if (!file_.is_open()) {
+        return false;
+    }
+    file_ << GENERATION_PREFIX << generation_ << '\n';
+    for (const auto &record : records) {
+        file_ << record << '\n';
+    }
+    recordCount_ = records.size();
+    file_.close();
+    file_.open(filename_, ios::app);
+    return file_.is_open();
+}
+
+bool FleetJournal::flush() {
+    if (!file_.is_open()) {
+        return false;
+    }
+    file_.flush();
+    return static_cast<bool>(file_);
+}
+
+void FleetJournal::setAutoFlush(bool autoFlush) {
+    autoFlush_ = autoFlush;
+    if (autoFlush_) {
+        flush();
+    }
+}
+
+size_t FleetJournal::getRecordCount() const { return recordCount_; }
+
+const string &FleetJournal::getFilename() const { return filename_; }
+
+unsigned long FleetJournal::getGeneration() const { return generation_; }
+
+bool FleetJournal::readRecords(const string &filename, unsigned long &generation,
+                               vector<string> &records, vector<size_t> &lineNumbers,
+                               bool &truncated) {
+    ifstream file(filename, ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+    string contents((istreambuf_iterator<char>(file)), istreambuf_iterator<char>());
+
+    generation = 0;
+    truncated = false;
+    size_t start = 0;
+    size_t lineNumber = 0;
+    if (contents.compare(0, GENERATION_PREFIX.size(), GENERATION_PREFIX) == 0) {
+        size_t end = contents.find('\n');
+        if (end == string::npos) {
+            truncated = true;
+            return true;
+        }
+        istringstream value(contents.substr(GENERATION_PREFIX.size(),
+                                            end - GENERATION_PREFIX.size()));
+        value >> generation;
+        start = end + 1;
+        lineNumber = 1;
+    }
+    // Записите на отворената партида чакат "#commit" в batch; ако вместо
+    // него дойде краят на файла или нова партида, те се изхвърлят.
+    vector<string> batch;
+    vector<size_t> batchLineNumbers;
+    bool inBatch = false;
+    size_t batchSize = 0;
+    while (start < contents.size()) {
+        size_t end = contents.find('\n', start);
+        if (end == string::npos) {
+            truncated = true;
+            break;
+        }
+        string line = contents.substr(start, end - start);
+        start = end + 1;
+        ++lineNumber;
+        if (line.compare(0, BATCH_BEGIN_PREFIX.size(), BATCH_BEGIN_PREFIX) == 0) {
+            truncated = truncated || inBatch;
+            istringstream value(line.substr(BATCH_BEGIN_PREFIX.size()));
+            batchSize = 0;
+            value >> batchSize;
+            batch.clear();
+            batchLineNumbers.clear();
+            inBatch = true;
+        } else if (line == BATCH_COMMIT) {
+            if (inBatch && batch.size() == batchSize) {
+                records.insert(records.end(), batch.begin(), batch.end());
+                lineNumbers.insert(lineNumbers.end(), batchLineNumbers.begin(),
+                                   batchLineNumbers.end());
+            }
+            batch.clear();
+            batchLineNumbers.clear();
+            inBatch = false;
+        } else if (!line.empty()) {
+            (inBatch ? batch : records).push_back(line);
+            (inBatch ? batchLineNumbers : lineNumbers).push_back(lineNumber);
+        }
+    }
+    truncated = truncated || inBatch;
+    return true;
+}
+
+vector<string> FleetJournal::splitRecord(const string &record) {
+    vector<string> fields;
+    size_t start = 0;
+    while (true) {
+        size_t tab = record.find('\t', start);
+        if (tab == string::npos) {
+            fields.push_back(record.substr(start));
+            return fields;
+        }
+        fields.push_back(record.substr(start, tab - start));
+        start = tab + 1;
+    }
+}
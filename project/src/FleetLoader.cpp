@@ -0,0 +1,228 @@
+#include "../headers/FleetLoader.h"
+#include "../headers/RecordReader.h"
+#include <algorithm>
+#include <fstream>
+#include <thread>
+
+using namespace std;
+
+namespace {
+
+const size_t MIN_AIRPLANE_CHUNK_BYTES = 1 << 20;
+const string_view GENERATION_PREFIX = "#generation ";
+
+void reportError(vector<LoadError> &errors, const string &filename, size_t lineNumber,
+                 const string &reason) {
+    errors.push_back(LoadError{filename, lineNumber, reason});
+}
+
+// Само първият ред на файла може да е заглавието с поколението; всеки друг
+// ред, започващ с '#', е запис и минава през обичайната проверка.
+bool isGenerationHeader(string_view line, bool firstLine) {
+    return firstLine && line.substr(0, GENERATION_PREFIX.size()) == GENERATION_PREFIX;
+}
+
+}
+
+LoadedFleetData FleetLoader::load(const string &planeClassesFile, const string &airplanesFile,
+                                  const string &destinationsFile, unsigned threadCount) {
+    LoadedFleetData data;
+    if (threadCount == 0) {
+        threadCount = max(1u, thread::hardware_concurrency());
+    }
+
+    string planeClassesContents;
+    string destinationsContents;
+    vector<LoadError> planeClassErrors;
+    vector<LoadError> destinationErrors;
+    thread planeClassesReader([&]() {
+        data.planeClassesFound = readWholeFile(planeClassesFile, planeClassesContents);
+        parsePlaneClasses(planeClassesFile, planeClassesContents, data.planeClasses,
+                          planeClassErrors);
+    });
+    thread destinationsReader([&]() {
+        data.destinationsFound = readWholeFile(destinationsFile, destinationsContents);
+        parseDestinations(destinationsFile, destinationsContents, data.destinations,
+                          destinationErrors);
+    });
+
+    string airplanesContents;
+    data.airplanesFound = readWholeFile(airplanesFile, airplanesContents);
+
+    size_t chunkCount = min<size_t>(threadCount,
+                                    airplanesContents.size() / MIN_AIRPLANE_CHUNK_BYTES + 1);
+    vector<size_t> boundaries(1, 0);
+    for (size_t i = 1; i < chunkCount; ++i) {
+        size_t position = airplanesContents.find('\n', i * airplanesContents.size() / chunkCount);
+        if (position == string::npos) {
+            break;
+        }
+        if (position + 1 > boundaries.back()) {
+            boundaries.push_back(position + 1);
+        }
+    }
+    boundaries.push_back(airplanesContents.size());
+
+    size_t chunks = boundaries.size() - 1;
+    vector<vector<AirplaneRow> > chunkRows(chunks);
+    vector<vector<LoadError> > chunkErrors(chunks);
+    vector<size_t> chunkLineCounts(chunks);
+    auto parseChunk = [&](size_t i) {
+        chunkLineCounts[i] = parseAirplanes(airplanesFile, airplanesContents, boundaries[i],
+                                            boundaries[i + 1], 1, chunkRows[i], chunkErrors[i]);
+    };
+    vector<thread> parsers;
+    for (size_t i = 1; i < chunks; ++i) {
+        parsers.emplace_back(parseChunk, i);
+    }
+    parseChunk(0);
+    for (auto &parser : parsers) {
+        parser.join();
+    }
+
+    size_t airplaneCount = 0;
+    for (const auto &rows : chunkRows) {
+        airplaneCount += rows.size();
+    }
+    data.airplanes.reserve(airplaneCount);
+    size_t linesBefore = 0;
+    for (size_t i = 0; i < chunks; ++i) {
+        for (auto &row : chunkRows[i]) {
+            row.lineNumber += linesBefore;
+            data.airplanes.push_back(move(row));
+        }
+        for (auto &error : chunkErrors[i]) {
+            error.lineNumber += linesBefore;
+            data.errors.push_back(error);
+        }
+        linesBefore += chunkLineCounts[i];
+    }
+
+    planeClassesReader.join();
+    destinationsReader.join();
+    data.errors.insert(data.errors.begin(), planeClassErrors.begin(), planeClassErrors.end());
+    data.errors.insert(data.errors.end(), destinationErrors.begin(), destinationErrors.end());
+    return data;
+}
+
+bool FleetLoader::readWholeFile(const string &filename, string &contents) {
+    ifstream file(filename, ios::binary | ios::ate);
+    if (!file.is_open()) {
+        return false;
+    }
+    streamsize size = file.tellg();
+    contents.resize(static_cast<size_t>(size));
+    file.seekg(0);
+    return static_cast<bool>(file.read(&contents[0], size));
+}
+
+void FleetLoader::parsePlaneClasses(const string &filename, string_view contents,
+                                    vector<PlaneClass> &planeClasses,
+                                    vector<LoadError> &errors) {
+    RecordReader reader(contents, 0, contents.size(), 1);
+    string_view line;
+    string_view fields[8];
+    while (reader.nextLine(line)) {
+        if (isGenerationHeader(line, reader.getLineNumber() == 1)) {
+            continue;
+        }
+        // Файловете отпреди табулациите са разделени с интервали и не
+        // допускат интервал в производителя или модела.
+        size_t fieldCount = line.find('\t') != string_view::npos
+                                ? RecordReader::splitFields(line, '\t', fields, 8)
+                                : RecordReader::splitWhitespace(line, fields, 8);
+        if (fieldCount != 8) {
+            reportError(errors, filename, reader.getLineNumber(), "очаквани 8 полета");
+            continue;
+        }
+
+        int seatCount, crewCount;
+        double minRunway, fuelConsumption, tankVolume, avgSpeed;
+        if (!RecordReader::parseInt(fields[2], seatCount) ||
+            !RecordReader::parseDouble(fields[3], minRunway) ||
+            !RecordReader::parseDouble(fields[4], fuelConsumption) ||
+            !RecordReader::parseDouble(fields[5], tankVolume) ||
+            !RecordReader::parseDouble(fields[6], avgSpeed) ||
+            !RecordReader::parseInt(fields[7], crewCount)) {
+            reportError(errors, filename, reader.getLineNumber(), "невалидно число");
+            continue;
+        }
+
+        try {
+            planeClasses.emplace_back(string(fields[0]), string(fields[1]), seatCount, minRunway,
+                                      fuelConsumption, tankVolume, avgSpeed, crewCount);
+        } catch (const exception &e) {
+            reportError(errors, filename, reader.getLineNumber(), e.what());
+        }
+    }
+}
+
+size_t FleetLoader::parseAirplanes(const string &filename, string_view contents, size_t begin,
+                                   size_t end, size_t firstLineNumber,
+                                   vector<AirplaneRow> &airplanes, vector<LoadError> &errors) {
+    RecordReader reader(contents, begin, end, firstLineNumber);
+    string_view line;
+    string_view fields[5];
+    while (reader.nextLine(line)) {
+        if (isGenerationHeader(line, begin == 0 && reader.getLineNumber() == firstLineNumber)) {
+            continue;
+        }
+        if (RecordReader::splitFields(line, '\t', fields, 5) != 5) {
+            reportError(errors, filename, reader.getLineNumber(), "очаквани 5 полета");
+            continue;
+        }
+
+        int operational, flightHours;
+        if (!RecordReader::parseInt(fields[2], operational) ||
+            !RecordReader::parseInt(fields[4], flightHours)) {
+            reportError(errors, filename, reader.getLineNumber(), "невалидно число");
+            continue;
+        }
+
+        airplanes.push_back(AirplaneRow{string(fields[0]), string(fields[1]), operational == 1,
+                                        string(fields[3]), flightHours,
+                                        reader.getLineNumber()});
+    }
+    return reader.getLineNumber() - firstLineNumber + 1;
+}
+
+void FleetLoader::parseDestinations(const string &filename, string_view contents,
+                                    vector<Destination> &destinations,
+                                    vector<LoadError> &errors) {
+    RecordReader reader(contents, 0, contents.size(), 1);
+    string_view line;
+    string_view fields[8];
+    while (reader.nextLine(line)) {
+        if (isGenerationHeader(line, reader.getLineNumber() == 1)) {
+            continue;
+        }
+        size_t fieldCount = RecordReader::splitFields(line, '\t', fields, 8);
+        if (fieldCount != 6 && fieldCount != 8) {
+            reportError(errors, filename, reader.getLineNumber(), "очаквани 6 или 8 полета");
+            continue;
+        }
+
+        double runwayLength, distance, latitude, longitude;
+        if (!RecordReader::parseDouble(fields[4], runwayLength) ||
+            !RecordReader::parseDouble(fields[5], distance) ||
+            (fieldCount == 8 && (!RecordReader::parseDouble(fields[6], latitude) ||
+                                 !RecordReader::parseDouble(fields[7], longitude)))) {
+            reportError(errors, filename, reader.getLineNumber(), "невалидно число");
+            continue;
+        }
+
+        try {
+            if (fieldCount == 8) {
+                destinations.emplace_back(string(fields[0]), string(fields[1]),
+                                          string(fields[2]), string(fields[3]), runwayLength,
+                                          distance, latitude, longitude);
+            } else {
+                destinations.emplace_back(string(fields[0]), string(fields[1]),
+                                          string(fields[2]), string(fields[3]), runwayLength,
+                                          distance);
+            }
+        } catch (const exception &e) {
+            reportError(errors, filename, reader.getLineNumber(), e.what());
+        }
+    }
+}
@@ -1,373 +1,1846 @@
 #include "../headers/FleetManager.h"
+#include "../headers/BinarySnapshot.h"
+#include "../headers/DurableFile.h"
+#include "../headers/RecordReader.h"
 #include <algorithm>
+#include <cstdio>
+#include <cstring>
 #include <iomanip>
+#include <limits>
 #include <sstream>
 
 using namespace std;
 
+namespace {
+
+// Дали обектът ще съществува след вече проверените операции на транзакция;
+// за ключове, които те не засягат, важи състоянието на флота.
+bool stagedExists(const unordered_map<string, bool> &staged, const string &key, bool inFleet) {
+    auto found = staged.find(key);
+    return found == staged.end() ? inFleet : found->second;
+}
+
+const string GENERATION_PREFIX = "#generation ";
+
+// Числата в журнала се разчитат строго, а грешката носи същото съобщение
+// като при файловете с данни.
+int journalInt(const string &text) {
+    int value;
+    if (!RecordReader::parseInt(text, value)) {
+        throw invalid_argument("невалидно число");
+    }
+    return value;
+}
+
+double journalDouble(const string &text) {
+    double value;
+    if (!RecordReader::parseDouble(text, value)) {
+        throw invalid_argument("невалидно число");
+    }
+    return value;
+}
+
+// Партидите идват една след друга, затова капацитетът расте геометрично;
+// резервиране точно за всяка партида би копирало всички записи всеки път.
+template <typename Values, typename Index>
+void reserveForAppend(Values &values, Index &index, size_t count) {
+    size_t required = values.size() + count;
+    if (required > values.capacity()) {
+        size_t target = max(required, values.capacity() * 2);
+        values.reserve(target);
+        index.reserve(target);
+    }
+}
+
+}
+
 FleetManager::FleetManager()
     : airplanes_(), destinations_(), planeClasses_(),
-      companyName_("Авиокомпания по подразбиране"), dataDirectory_("./data") {}
+      companyName_("Авиокомпания по подразбиране"), dataDirectory_("./data"),
+      planeClassRangeIndex_(), planeClassRangeIndexDirty_(false), journal_(),
+      journalCompactionThreshold_(0), journalSuppressionDepth_(0),
+      bulkUpdateDepth_(0), lastLoadErrors_(), writeMutex_(), writeDepth_(0),
+      publishingEnabled_(false), snapshotDirty_(true),
+      snapshotVersion_(0), currentSnapshot_(nullptr),
+      publishedAirplanes_(), publishedDestinations_(), publishedAirplanePositions_(),
+      publishedDestinationPositions_(), publishedCompatibility_(), routePlanner_(),
+      geoIndex_(), distanceCache_(),
+      views_(), viewsEnabled_(false), subscribers_(), pendingChanges_(),
+      capturingRecords_(false), capturedRecords_() {}
 
 FleetManager::FleetManager(const string &companyName, const string &dataDirectory)
     : airplanes_(), destinations_(), planeClasses_(), companyName_(companyName),
-      dataDirectory_(dataDirectory) {}
-
+      dataDirectory_(dataDirectory), planeClassRangeIndex_(), planeClassRangeIndexDirty_(false),
+      journal_(), journalCompactionThreshold_(0),
+      journalSuppressionDepth_(0), bulkUpdateDepth_(0), lastLoadErrors_(), writeMutex_(),
+      writeDepth_(0), publishingEnabled_(false), snapshotDirty_(true),
+      snapshotVersion_(0), currentSnapshot_(nullptr),
+      publishedAirplanes_(), publishedDestinations_(), publishedAirplanePositions_(),
+      publishedDestinationPositions_(), publishedCompatibility_(), routePlanner_(),
+      geoIndex_(), distanceCache_(),
+      views_(), viewsEnabled_(false), subscribers_(), pendingChanges_(),
+      capturingRecords_(false), capturedRecords_() {}
+
+// Записите за класовете не се променят след създаването си, затова копието
+// ги споделя с оригинала и airplanesByClass_ може да се копира както е.
 FleetManager::FleetManager(const FleetManager &other)
     : airplanes_(other.airplanes_), destinations_(other.destinations_),
       planeClasses_(other.planeClasses_), companyName_(other.companyName_),
-      dataDirectory_(other.dataDirectory_) {}
+      dataDirectory_(other.dataDirectory_),
+      airplaneIndexById_(other.airplaneIndexById_),
+      destinationIndexByCode_(other.destinationIndexByCode_),
+      planeClassIndexById_(other.planeClassIndexById_),
+      compatibilityIndex_(other.compatibilityIndex_),
+      planeClassRangeIndex_(other.planeClassRangeIndex_),
+      planeClassRangeIndexDirty_(other.planeClassRangeIndexDirty_),
+      airplanesByClass_(other.airplanesByClass_),
+      journal_(),
+      journalCompactionThreshold_(0), journalSuppressionDepth_(0),
+      bulkUpdateDepth_(0), lastLoadErrors_(other.lastLoadErrors_), writeMutex_(),
+      writeDepth_(0), publishingEnabled_(false), snapshotDirty_(true),
+      snapshotVersion_(0), currentSnapshot_(nullptr),
+      publishedAirplanes_(), publishedDestinations_(), publishedAirplanePositions_(),
+      publishedDestinationPositions_(), publishedCompatibility_(), routePlanner_(),
+      geoIndex_(), distanceCache_(),
+      views_(), viewsEnabled_(false), subscribers_(), pendingChanges_(),
+      capturingRecords_(false), capturedRecords_() {}
+
+FleetManager::~FleetManager() {
+    const FleetSnapshot *snapshot = currentSnapshot_.exchange(nullptr);
+    if (snapshot != nullptr) {
+        EpochReclaimer::retire(snapshot);
+    }
+}
+
+FleetManager::WriteScope::WriteScope(FleetManager &manager) : manager_(manager) {
+    manager_.beginWrite();
+}
 
-FleetManager::~FleetManager() {}
+FleetManager::WriteScope::~WriteScope() { manager_.endWrite(); }
+
+FleetManager::SnapshotReader::SnapshotReader(const atomic<const FleetSnapshot *> &current)
+    : guard_(), snapshot_(current.load()) {}
+
+const FleetSnapshot &FleetManager::SnapshotReader::operator*() const { return *snapshot_; }
+
+const FleetSnapshot *FleetManager::SnapshotReader::operator->() const { return snapshot_; }
+
+FleetManager::SnapshotReader FleetManager::readSnapshot() const {
+    if (currentSnapshot_.load() == nullptr) {
+        // Първото четене включва публикуването; дотогава писателите не
+        // плащат за копие, което никой не чете.
+        lock_guard<recursive_mutex> lock(writeMutex_);
+        enablePublishing();
+        if (currentSnapshot_.load() == nullptr) {
+            // Само писателят може да стигне дотук по средата на своя промяна.
+            publishSnapshot();
+        }
+    }
+    return SnapshotReader(currentSnapshot_);
+}
+
+shared_ptr<const FleetSnapshot> FleetManager::takeSnapshot() const {
+    // Писател в средата на промяна получава и собствените си непубликувани
+    // промени, без те да стават видими за останалите читатели.
+    lock_guard<recursive_mutex> lock(writeMutex_);
+    unsigned long version = snapshotVersion_ + (snapshotDirty_ ? 1 : 0);
+    if (publishingEnabled_) {
+        // Под ключалката се копират само корените на устойчивите структури и
+        // списъкът с класове; обхождането на версията става след освобождаването ѝ.
+        return shared_ptr<const FleetSnapshot>(makeSnapshot(version));
+    }
+    // Извеждането и записването не включват публикуването: еднократното
+    // копие се строи отделно, а промените след него не плащат за устойчиви копия.
+    PersistentVector<Airplane> airplanes;
+    PersistentVector<Destination> destinations;
+    PersistentMap<string, uint32_t> airplanePositions;
+    PersistentMap<string, uint32_t> destinationPositions;
+    SnapshotCompatibility compatibility;
+    fillPersistentState(airplanes, destinations, airplanePositions, destinationPositions,
+                        compatibility);
+    return make_shared<const FleetSnapshot>(version, companyName_, airplanes, destinations,
+                                            planeClasses_.values(), airplanePositions,
+                                            destinationPositions, compatibility);
+}
+
+void FleetManager::beginWrite() {
+    writeMutex_.lock();
+    ++writeDepth_;
+}
+
+void FleetManager::endWrite() {
+    if (--writeDepth_ == 0) {
+        if (publishingEnabled_ && snapshotDirty_) {
+            try {
+                publishSnapshot();
+            } catch (const exception &) {
+                // Старата версия остава публикувана; следващата промяна ще опита отново.
+            }
+        }
+        flushChanges();
+    }
+    writeMutex_.unlock();
+}
+
+void FleetManager::enablePublishing() const {
+    if (publishingEnabled_) {
+        return;
+    }
+    publishingEnabled_ = true;
+    rebuildPublishedState();
+    snapshotDirty_ = true;
+    if (writeDepth_ == 0) {
+        publishSnapshot();
+    }
+}
+
+FleetSnapshot *FleetManager::makeSnapshot(unsigned long version) const {
+    return new FleetSnapshot(version, companyName_, publishedAirplanes_, publishedDestinations_,
+                             planeClasses_.values(), publishedAirplanePositions_,
+                             publishedDestinationPositions_, publishedCompatibility_);
+}
+
+void FleetManager::publishSnapshot() const {
+    const FleetSnapshot *snapshot = makeSnapshot(++snapshotVersion_);
+    snapshotDirty_ = false;
+    const FleetSnapshot *previous = currentSnapshot_.exchange(snapshot);
+    if (previous != nullptr) {
+        EpochReclaimer::retire(previous);
+    }
+}
+
+void FleetManager::clearPublishedState() const {
+    publishedAirplanes_.clear();
+    publishedDestinations_.clear();
+    publishedAirplanePositions_.clear();
+    publishedDestinationPositions_.clear();
+    publishedCompatibility_.clear();
+}
+
+void FleetManager::rebuildPublishedState() const {
+    clearPublishedState();
+    fillPersistentState(publishedAirplanes_, publishedDestinations_, publishedAirplanePositions_,
+                        publishedDestinationPositions_, publishedCompatibility_);
+}
+
+void FleetManager::fillPersistentState(PersistentVector<Airplane> &airplaneCopies,
+                                       PersistentVector<Destination> &destinationCopies,
+                                       PersistentMap<string, uint32_t> &airplanePositions,
+                                       PersistentMap<string, uint32_t> &destinationPositions,
+                                       SnapshotCompatibility &compatibility) const {
+    const vector<Airplane> &airplanes = airplanes_.values();
+    for (size_t i = 0; i < airplanes.size(); ++i) {
+        airplaneCopies.push_back(airplanes[i]);
+        airplanePositions.set(airplanes[i].getIdentificationNumberRef(), static_cast<uint32_t>(i));
+        compatibility.set(i, airplanes[i]);
+    }
+
+    const vector<Destination> &destinations = destinations_.values();
+    for (size_t i = 0; i < destinations.size(); ++i) {
+        destinationCopies.push_back(destinations[i]);
+        destinationPositions.set(destinations[i].getCodeRef(), static_cast<uint32_t>(i));
+    }
+}
+
+void FleetManager::publishAirplaneAt(size_t position) {
+    if (!publishingEnabled_) {
+        return;
+    }
+    const Airplane &airplane = airplanes_.values()[position];
+    publishedCompatibility_.set(position, airplane);
+    if (position == publishedAirplanes_.size()) {
+        publishedAirplanes_.push_back(airplane);
+        publishedAirplanePositions_.set(airplane.getIdentificationNumberRef(),
+                                        static_cast<uint32_t>(position));
+    } else {
+        publishedAirplanes_.set(position, airplane);
+    }
+}
+
+// Извиква се след премахването от SlotMap, която е преместила последния
+// самолет на освободената позиция; копието повтаря същото преместване.
+void FleetManager::unpublishAirplane(const string &id, size_t position) {
+    if (!publishingEnabled_) {
+        return;
+    }
+    publishedAirplanePositions_.erase(id);
+    if (position < airplanes_.size()) {
+        const Airplane &moved = airplanes_.values()[position];
+        publishedAirplanes_.set(position, moved);
+        publishedAirplanePositions_.set(moved.getIdentificationNumberRef(),
+                                        static_cast<uint32_t>(position));
+        publishedCompatibility_.set(position, moved);
+    }
+    publishedAirplanes_.pop_back();
+    publishedCompatibility_.popBack();
+}
+
+void FleetManager::publishDestinationAt(size_t position) {
+    if (!publishingEnabled_) {
+        return;
+    }
+    const Destination &destination = destinations_.values()[position];
+    if (position == publishedDestinations_.size()) {
+        publishedDestinations_.push_back(destination);
+        publishedDestinationPositions_.set(destination.getCodeRef(),
+                                           static_cast<uint32_t>(position));
+    } else {
+        publishedDestinations_.set(position, destination);
+    }
+}
+
+void FleetManager::unpublishDestination(const string &code, size_t position) {
+    if (!publishingEnabled_) {
+        return;
+    }
+    publishedDestinationPositions_.erase(code);
+    if (position < destinations_.size()) {
+        const Destination &moved = destinations_.values()[position];
+        publishedDestinations_.set(position, moved);
+        publishedDestinationPositions_.set(moved.getCodeRef(), static_cast<uint32_t>(position));
+    }
+    publishedDestinations_.pop_back();
+}
 
 string FleetManager::getCompanyName() const { return companyName_; }
 
 string FleetManager::getDataDirectory() const { return dataDirectory_; }
 
+string FleetManager::getSnapshotFilePath() const {
+    return dataDirectory_ + "/" + SNAPSHOT_FILE_NAME;
+}
+
 size_t FleetManager::getAirplaneCount() const { return airplanes_.size(); }
 
+size_t FleetManager::getOperationalAirplaneCount() const {
+    lock_guard<recursive_mutex> lock(writeMutex_);
+    enableViews();
+    return views_.getOperationalAirplanes().size();
+}
+
 size_t FleetManager::getDestinationCount() const { return destinations_.size(); }
 
 size_t FleetManager::getPlaneClassCount() const { return planeClasses_.size(); }
 
-const vector<Airplane> &FleetManager::getAirplanes() const { return airplanes_; }
+const vector<Airplane> &FleetManager::getAirplanes() const { return airplanes_.values(); }
 
-const vector<Destination> &FleetManager::getDestinations() const { return destinations_; }
+const vector<Destination> &FleetManager::getDestinations() const { return destinations_.values(); }
 
-const vector<PlaneClass> &FleetManager::getPlaneClasses() const { return planeClasses_; }
+const vector<shared_ptr<const PlaneClass> > &FleetManager::getPlaneClasses() const {
+    return planeClasses_.values();
+}
 
-void FleetManager::setCompanyName(const string &name) { companyName_ = name; }
+void FleetManager::setCompanyName(const string &name) {
+    WriteScope scope(*this);
+    companyName_ = name;
+    snapshotDirty_ = true;
+}
 
 void FleetManager::setDataDirectory(const string &directory) { dataDirectory_ = directory; }
 
 bool FleetManager::addPlaneClass(const PlaneClass &planeClassToAdd) {
-    for (const auto &planeClass : planeClasses_) {
-        if (planeClass == planeClassToAdd) {
-            return false;
-        }
+    WriteScope scope(*this);
+    const string &classId = planeClassToAdd.getClassIdRef();
+    if (planeClassIndexById_.count(classId) != 0) {
+        return false;
     }
-    planeClasses_.push_back(planeClassToAdd);
+    planeClassIndexById_.emplace(classId,
+                                 planeClasses_.insert(make_shared<PlaneClass>(planeClassToAdd)));
+    planeClassRangeIndexDirty_ = true;
+    recordChange(PLANE_CLASS_ADDED, classId,
+                 isJournaling() ? formatPlaneClassRecord("C", planeClassToAdd) : string());
     return true;
 }
 
 bool FleetManager::addAirplane(const Airplane &airplaneToAdd) {
-    for (const auto &airplane : airplanes_) {
-        if (airplane == airplaneToAdd) {
-            return false;
-        }
+    return addAirplane(Airplane(airplaneToAdd));
+}
+
+bool FleetManager::addAirplane(Airplane &&airplaneToAdd) {
+    WriteScope scope(*this);
+    if (airplaneIndexById_.count(airplaneToAdd.getIdentificationNumberRef()) != 0) {
+        return false;
+    }
+
+    const PlaneClass &planeClass = airplaneToAdd.getPlaneClassRef();
+    shared_ptr<const PlaneClass> registered = findSharedPlaneClass(planeClass.getClassIdRef());
+    if (!registered) {
+        addPlaneClass(planeClass);
+        registered = findSharedPlaneClass(planeClass.getClassIdRef());
+    }
+    return insertAirplane(move(airplaneToAdd), registered);
+}
+
+bool FleetManager::insertAirplane(Airplane airplaneToAdd,
+                                  const shared_ptr<const PlaneClass> &registered) {
+    auto inserted = airplaneIndexById_.emplace(airplaneToAdd.getIdentificationNumberRef(),
+                                               AirplaneHandle());
+    if (!inserted.second) {
+        return false;
     }
-    airplanes_.push_back(airplaneToAdd);
+
+    AirplaneHandle handle = airplanes_.insert(move(airplaneToAdd));
+    Airplane *added = airplanes_.get(handle);
+    added->setPlaneClass(registered);
+    inserted.first->second = handle;
+    compatibilityIndex_.append(*added);
+    airplanesByClass_[registered.get()].push_back(handle);
+    if (viewsEnabled_) {
+        addAirplaneToViews(handle);
+    }
+    publishAirplaneAt(airplanes_.size() - 1);
+    string record;
+    if (isJournaling()) {
+        record = "A\t" + added->getIdentificationNumberRef() + "\t" + registered->getClassIdRef() +
+                 "\t" + (added->isOperational() ? "1" : "0") + "\t" +
+                 added->getBaseAirportCodeRef() + "\t" + to_string(added->getTotalFlightHours());
+    }
+    recordChange(AIRPLANE_ADDED, added->getIdentificationNumberRef(), record);
     return true;
 }
 
 bool FleetManager::addDestination(const Destination &destinationToAdd) {
-    for (const auto &destination : destinations_) {
-        if (destination == destinationToAdd) {
-            return false;
+    return addDestination(Destination(destinationToAdd));
+}
+
+bool FleetManager::addDestination(Destination &&destinationToAdd) {
+    WriteScope scope(*this);
+    const string &code = destinationToAdd.getCodeRef();
+    if (destinationIndexByCode_.count(code) != 0) {
+        return false;
+    }
+    DestinationHandle handle = destinations_.insert(move(destinationToAdd));
+    const Destination &added = *destinations_.get(handle);
+    destinationIndexByCode_.emplace(added.getCodeRef(), handle);
+    publishDestinationAt(destinations_.size() - 1);
+    if (viewsEnabled_) {
+        addDestinationToViews(handle);
+        refreshAirplanesBasedAt(added.getCodeRef());
+    }
+    routePlanner_.reset();
+    geoIndex_.reset();
+    ostringstream record;
+    if (isJournaling()) {
+        record << setprecision(numeric_limits<double>::max_digits10) << "D\t"
+               << added.getCodeRef() << "\t" << added.getName() << "\t" << added.getCity()
+               << "\t" << added.getCountry() << "\t" << added.getRunwayLengthMeters() << "\t"
+               << added.getDistanceFromBaseKm();
+        if (added.hasCoordinates()) {
+            record << "\t" << added.getLatitude() << "\t" << added.getLongitude();
         }
     }
-    destinations_.push_back(destinationToAdd);
+    recordChange(DESTINATION_ADDED, added.getCodeRef(), record.str());
     return true;
 }
 
-bool FleetManager::removeAirplaneById(const string &id) {
-    auto it = remove_if(airplanes_.begin(), airplanes_.end(),
-        [&id](const Airplane &a) { return a.getIdentificationNumber() == id; });
+size_t FleetManager::addPlaneClasses(const vector<PlaneClass> &planeClassesToAdd) {
+    WriteScope scope(*this);
+    reserveForAppend(planeClasses_, planeClassIndexById_, planeClassesToAdd.size());
+    beginBulkUpdate();
+    size_t added = 0;
+    for (const auto &planeClass : planeClassesToAdd) {
+        added += addPlaneClass(planeClass) ? 1 : 0;
+    }
+    endBulkUpdate();
+    return added;
+}
 
-    if (it == airplanes_.end()) {
+size_t FleetManager::addAirplanes(const vector<Airplane> &airplanesToAdd) {
+    WriteScope scope(*this);
+    reserveForAppend(airplanes_, airplaneIndexById_, airplanesToAdd.size());
+    beginBulkUpdate();
+    size_t added = 0;
+    for (const auto &airplane : airplanesToAdd) {
+        added += addAirplane(airplane) ? 1 : 0;
+    }
+    endBulkUpdate();
+    return added;
+}
+
+size_t FleetManager::addDestinations(const vector<Destination> &destinationsToAdd) {
+    WriteScope scope(*this);
+    reserveForAppend(destinations_, destinationIndexByCode_, destinationsToAdd.size());
+    beginBulkUpdate();
+    size_t added = 0;
+    for (const auto &destination : destinationsToAdd) {
+        added += addDestination(destination) ? 1 : 0;
+    }
+    endBulkUpdate();
+    return added;
+}
+
+void FleetManager::beginBulkUpdate() {
+    beginWrite();
+    if (bulkUpdateDepth_++ == 0 && journal_) {
+        journal_->setAutoFlush(false);
+    }
+}
+
+void FleetManager::endBulkUpdate() {
+    if (bulkUpdateDepth_ == 0) {
+        return;
+    }
+    if (--bulkUpdateDepth_ == 0 && journal_) {
+        journal_->setAutoFlush(true);
+        if (journalNeedsCompaction()) {
+            saveAllData();
+        }
+    }
+    endWrite();
+}
+
+bool FleetManager::removeAirplaneById(const string &id) {
+    WriteScope scope(*this);
+    auto found = airplaneIndexById_.find(id);
+    if (found == airplaneIndexById_.end()) {
         return false;
     }
 
-    airplanes_.erase(it, airplanes_.end());
+    size_t position = airplanes_.denseIndexOf(found->second);
+    vector<AirplaneHandle> &classMembers =
+        airplanesByClass_[&airplanes_.get(found->second)->getPlaneClassRef()];
+    classMembers.erase(find(classMembers.begin(), classMembers.end(), found->second));
+    if (viewsEnabled_) {
+        removeAirplaneFromViews(found->second);
+    }
+    airplanes_.erase(found->second);
+    compatibilityIndex_.removeBySwapWithLast(position);
+    airplaneIndexById_.erase(found);
+    unpublishAirplane(id, position);
+    recordChange(AIRPLANE_REMOVED, id, "R\t" + id);
     return true;
 }
 
 bool FleetManager::removeDestinationByCode(const string &code) {
-    auto it = remove_if(destinations_.begin(), destinations_.end(),
-        [&code](const Destination &d) { return d.getCode() == code; });
+    WriteScope scope(*this);
+    auto found = destinationIndexByCode_.find(code);
+    if (found == destinationIndexByCode_.end()) {
+        return false;
+    }
+
+    size_t position = destinations_.denseIndexOf(found->second);
+    if (viewsEnabled_) {
+        views_.unlinkDestination(found->second);
+    }
+    destinations_.erase(found->second);
+    destinationIndexByCode_.erase(found);
+    unpublishDestination(code, position);
+    routePlanner_.reset();
+    geoIndex_.reset();
+    distanceCache_.forget(code);
+    if (viewsEnabled_) {
+        refreshAirplanesBasedAt(code);
+    }
+    recordChange(DESTINATION_REMOVED, code, "X\t" + code);
+    return true;
+}
+
+bool FleetManager::updatePlaneClass(const PlaneClass &planeClass) {
+    WriteScope scope(*this);
+    shared_ptr<const PlaneClass> registered = findSharedPlaneClass(planeClass.getClassIdRef());
+    if (!registered) {
+        return false;
+    }
+
+    // Публикуваните версии споделят стария обект, затова той не се променя,
+    // а самолетите от класа се пренасочват към ново копие.
+    shared_ptr<const PlaneClass> replacement = make_shared<PlaneClass>(planeClass);
+    vector<AirplaneHandle> members = move(airplanesByClass_[registered.get()]);
+    airplanesByClass_.erase(registered.get());
+    for (AirplaneHandle handle : members) {
+        Airplane *airplane = airplanes_.get(handle);
+        airplane->setPlaneClass(replacement);
+        size_t position = airplanes_.denseIndexOf(handle);
+        compatibilityIndex_.update(position, *airplane);
+        publishAirplaneAt(position);
+        if (viewsEnabled_) {
+            removeAirplaneFromViews(handle);
+            addAirplaneToViews(handle);
+        }
+    }
+    airplanesByClass_[replacement.get()] = move(members);
+    *planeClasses_.get(planeClassIndexById_.at(planeClass.getClassIdRef())) = replacement;
+    planeClassRangeIndexDirty_ = true;
+    routePlanner_.reset();
+    recordChange(PLANE_CLASS_UPDATED, planeClass.getClassIdRef(),
+                 formatPlaneClassRecord("U", planeClass));
+    return true;
+}
 
-    if (it == destinations_.end()) {
+bool FleetManager::setAirplaneOperational(const string &id, bool operational) {
+    WriteScope scope(*this);
+    AirplaneHandle handle = findAirplaneHandleById(id);
+    Airplane *airplane = airplanes_.get(handle);
+    if (airplane == nullptr) {
         return false;
     }
 
-    destinations_.erase(it, destinations_.end());
+    bool changed = airplane->isOperational() != operational;
+    airplane->setOperational(operational);
+    size_t position = airplanes_.denseIndexOf(handle);
+    compatibilityIndex_.update(position, *airplane);
+    publishAirplaneAt(position);
+    if (viewsEnabled_ && changed) {
+        removeAirplaneFromViews(handle);
+        addAirplaneToViews(handle);
+    }
+    recordChange(AIRPLANE_OPERATIONAL_CHANGED, id,
+                 "O\t" + id + "\t" + (operational ? "1" : "0"));
     return true;
 }
 
-Airplane *FleetManager::findAirplaneById(const string &id) {
-    for (auto &airplane : airplanes_) {
-        if (airplane.getIdentificationNumber() == id) {
-            return &airplane;
+bool FleetManager::setDestinationRunwayLength(const string &code, double length) {
+    WriteScope scope(*this);
+    DestinationHandle handle = findDestinationHandleByCode(code);
+    Destination *destination = destinations_.get(handle);
+    if (destination == nullptr) {
+        return false;
+    }
+
+    double previousLength = destination->getRunwayLengthMeters();
+    destination->setRunwayLengthMeters(length);
+    publishDestinationAt(destinations_.denseIndexOf(handle));
+    routePlanner_.reset();
+    if (viewsEnabled_) {
+        // По-къса писта може само да отнеме самолети от списъка, а по-дълга -
+        // само да добави такива, които досега не са стигали до нея.
+        if (length < previousLength) {
+            vector<AirplaneHandle> linked = views_.getAirplanesForDestination(handle);
+            views_.unlinkDestination(handle);
+            for (AirplaneHandle airplane : linked) {
+                if (airplanes_.get(airplane)->getPlaneClassRef().isCompatibleWithRunway(length)) {
+                    views_.link(handle, airplane);
+                }
+            }
+        } else if (length > previousLength) {
+            vector<double> baseDistances(compatibilityIndex_.getBaseAirportCount());
+            computeBaseDistances(*destination, baseDistances.data());
+            vector<uint32_t> positions;
+            compatibilityIndex_.findCompatible(length, baseDistances.data(), positions);
+            for (uint32_t position : positions) {
+                const PlaneClass &planeClass = airplanes_.values()[position].getPlaneClassRef();
+                if (!planeClass.isCompatibleWithRunway(previousLength)) {
+                    views_.link(handle, airplanes_.handleAt(position));
+                }
+            }
         }
     }
-    return nullptr;
+    ostringstream record;
+    record << setprecision(numeric_limits<double>::max_digits10) << "W\t" << code << "\t"
+           << length;
+    recordChange(DESTINATION_RUNWAY_CHANGED, code, record.str());
+    return true;
+}
+
+bool FleetManager::addAirplaneFlightHours(const string &id, int hours) {
+    WriteScope scope(*this);
+    AirplaneHandle handle = findAirplaneHandleById(id);
+    Airplane *airplane = airplanes_.get(handle);
+    if (airplane == nullptr) {
+        return false;
+    }
+
+    airplane->addFlightHours(hours);
+    publishAirplaneAt(airplanes_.denseIndexOf(handle));
+    recordChange(AIRPLANE_HOURS_ADDED, id, "H\t" + id + "\t" + to_string(hours));
+    return true;
+}
+
+bool FleetManager::setAirplaneBase(const string &id, const string &baseAirportCode) {
+    WriteScope scope(*this);
+    AirplaneHandle handle = findAirplaneHandleById(id);
+    Airplane *airplane = airplanes_.get(handle);
+    if (airplane == nullptr) {
+        return false;
+    }
+
+    airplane->setBaseAirportCode(baseAirportCode);
+    size_t position = airplanes_.denseIndexOf(handle);
+    compatibilityIndex_.update(position, *airplane);
+    publishAirplaneAt(position);
+    if (viewsEnabled_) {
+        removeAirplaneFromViews(handle);
+        addAirplaneToViews(handle);
+    }
+    recordChange(AIRPLANE_BASE_CHANGED, id, "B\t" + id + "\t" + baseAirportCode);
+    return true;
 }
 
-Destination *FleetManager::findDestinationByCode(const string &code) {
-    for (auto &destination : destinations_) {
-        if (destination.getCode() == code) {
-            return &destination;
+TransactionResult FleetManager::commitTransaction(const FleetTransaction &transaction) {
+    WriteScope scope(*this);
+    TransactionResult result{TRANSACTION_COMMITTED, transaction.size(), ""};
+    if (!validateTransaction(transaction, result)) {
+        return result;
+    }
+
+    beginBulkUpdate();
+    size_t firstPendingChange = pendingChanges_.size();
+    capturingRecords_ = true;
+    vector<function<void()> > undo;
+    const vector<FleetTransaction::Operation> &operations = transaction.getOperations();
+    for (size_t i = 0; i < operations.size() && result.status == TRANSACTION_COMMITTED; ++i) {
+        try {
+            if (!applyOperation(transaction, operations[i], undo)) {
+                result = TransactionResult{TRANSACTION_ROLLED_BACK, i,
+                                           "операцията не може да бъде приложена"};
+            }
+        } catch (const exception &error) {
+            result = TransactionResult{TRANSACTION_ROLLED_BACK, i, error.what()};
         }
     }
-    return nullptr;
+    if (result.status == TRANSACTION_ROLLED_BACK) {
+        // Обратните операции минават през същите методи, затова и те
+        // пишат в capturedRecords_ и pendingChanges_; и двете се изхвърлят.
+        for (auto step = undo.rbegin(); step != undo.rend(); ++step) {
+            (*step)();
+        }
+        capturedRecords_.clear();
+        pendingChanges_.erase(pendingChanges_.begin() + firstPendingChange,
+                              pendingChanges_.end());
+    }
+    capturingRecords_ = false;
+    if (!capturedRecords_.empty()) {
+        journal_->appendBatch(capturedRecords_);
+    }
+    capturedRecords_.clear();
+    endBulkUpdate();
+    return result;
 }
 
-PlaneClass *FleetManager::findPlaneClassById(const string &classId) {
-    for (auto &planeClass : planeClasses_) {
-        if (planeClass.getClassId() == classId) {
-            return &planeClass;
+bool FleetManager::validateTransaction(const FleetTransaction &transaction,
+                                       TransactionResult &result) const {
+    unordered_map<string, bool> airplanes;
+    unordered_map<string, bool> destinations;
+    unordered_map<string, bool> planeClasses;
+    const vector<FleetTransaction::Operation> &operations = transaction.getOperations();
+    for (size_t i = 0; i < operations.size(); ++i) {
+        const FleetTransaction::Operation &operation = operations[i];
+        const string &key = operation.key;
+        const char *error = nullptr;
+        switch (operation.type) {
+        case FleetTransaction::ADD_PLANE_CLASS:
+        case FleetTransaction::UPDATE_PLANE_CLASS: {
+            bool exists = stagedExists(planeClasses, key, planeClassIndexById_.count(key) != 0);
+            if (operation.type == FleetTransaction::UPDATE_PLANE_CLASS) {
+                error = exists ? nullptr : "непознат клас самолет";
+            } else if (exists) {
+                error = "класът вече съществува";
+            } else {
+                planeClasses[key] = true;
+            }
+            break;
+        }
+        case FleetTransaction::ADD_AIRPLANE: {
+            const Airplane &airplane = transaction.getAirplane(operation.item);
+            const string &classId = airplane.getPlaneClassRef().getClassIdRef();
+            if (stagedExists(airplanes, key, airplaneIndexById_.count(key) != 0)) {
+                error = "самолетът вече съществува";
+            } else if (!stagedExists(planeClasses, classId,
+                                     planeClassIndexById_.count(classId) != 0)) {
+                error = "непознат клас самолет";
+            } else {
+                airplanes[key] = true;
+            }
+            break;
+        }
+        case FleetTransaction::REMOVE_AIRPLANE:
+        case FleetTransaction::SET_AIRPLANE_OPERATIONAL:
+        case FleetTransaction::ADD_AIRPLANE_FLIGHT_HOURS:
+        case FleetTransaction::SET_AIRPLANE_BASE:
+            if (!stagedExists(airplanes, key, airplaneIndexById_.count(key) != 0)) {
+                error = "няма такъв самолет";
+            } else if (operation.type == FleetTransaction::REMOVE_AIRPLANE) {
+                airplanes[key] = false;
+            } else if (operation.type == FleetTransaction::ADD_AIRPLANE_FLIGHT_HOURS &&
+                       operation.value < 0.0) {
+                error = "летателните часове не могат да са отрицателни";
+            } else if (operation.type == FleetTransaction::SET_AIRPLANE_BASE &&
+                       operation.text.empty()) {
+                error = "кодът на базата е празен";
+            }
+            break;
+        case FleetTransaction::ADD_DESTINATION:
+            if (stagedExists(destinations, key, destinationIndexByCode_.count(key) != 0)) {
+                error = "дестинацията вече съществува";
+            } else {
+                destinations[key] = true;
+            }
+            break;
+        case FleetTransaction::REMOVE_DESTINATION:
+        case FleetTransaction::SET_DESTINATION_RUNWAY:
+            if (!stagedExists(destinations, key, destinationIndexByCode_.count(key) != 0)) {
+                error = "няма такава дестинация";
+            } else if (operation.type == FleetTransaction::REMOVE_DESTINATION) {
+                destinations[key] = false;
+            } else if (operation.value <= 0.0) {
+                error = "дължината на пистата трябва да е по-голяма от 0";
+            }
+            break;
+        }
+        if (error != nullptr) {
+            result = TransactionResult{TRANSACTION_REJECTED, i, error};
+            return false;
         }
     }
-    return nullptr;
+    return true;
 }
 
-vector<Airplane *> FleetManager::findAirplanesForDestination(const string &destinationCode) {
-    vector<Airplane *> compatibleAirplanes;
+bool FleetManager::applyOperation(const FleetTransaction &transaction,
+                                  const FleetTransaction::Operation &operation,
+                                  vector<function<void()> > &undo) {
+    // Всяка успешна операция оставя в undo обратната си. Обратните се
+    // изпълняват в обратен ред, затова търсят обектите по ключ, а не по
+    // манипулатор: отменено премахване добавя самолета под нов манипулатор.
+    const string &key = operation.key;
+    switch (operation.type) {
+    case FleetTransaction::ADD_PLANE_CLASS:
+        if (!addPlaneClass(transaction.getPlaneClass(operation.item))) {
+            return false;
+        }
+        undo.push_back([this, key]() { erasePlaneClass(key); });
+        return true;
+    case FleetTransaction::UPDATE_PLANE_CLASS: {
+        // Обновяването подменя обекта на класа, а не го променя.
+        shared_ptr<const PlaneClass> previous = findSharedPlaneClass(key);
+        if (!previous || !updatePlaneClass(transaction.getPlaneClass(operation.item))) {
+            return false;
+        }
+        undo.push_back([this, previous]() { updatePlaneClass(*previous); });
+        return true;
+    }
+    case FleetTransaction::ADD_AIRPLANE:
+        if (!addAirplane(transaction.getAirplane(operation.item))) {
+            return false;
+        }
+        undo.push_back([this, key]() { removeAirplaneById(key); });
+        return true;
+    case FleetTransaction::REMOVE_AIRPLANE: {
+        const Airplane *airplane = airplanes_.get(findAirplaneHandleById(key));
+        if (airplane == nullptr) {
+            return false;
+        }
+        Airplane removed(*airplane);
+        if (!removeAirplaneById(key)) {
+            return false;
+        }
+        undo.push_back([this, removed]() {
+            insertAirplane(removed,
+                           findSharedPlaneClass(removed.getPlaneClassRef().getClassIdRef()));
+        });
+        return true;
+    }
+    case FleetTransaction::SET_AIRPLANE_OPERATIONAL: {
+        const Airplane *airplane = airplanes_.get(findAirplaneHandleById(key));
+        if (airplane == nullptr) {
+            return false;
+        }
+        bool previous = airplane->isOperational();
+        if (!setAirplaneOperational(key, operation.flag)) {
+            return false;
+        }
+        undo.push_back([this, key, previous]() { setAirplaneOperational(key, previous); });
+        return true;
+    }
+    case FleetTransaction::ADD_AIRPLANE_FLIGHT_HOURS: {
+        const Airplane *airplane = airplanes_.get(findAirplaneHandleById(key));
+        if (airplane == nullptr) {
+            return false;
+        }
+        int previous = airplane->getTotalFlightHours();
+        if (!addAirplaneFlightHours(key, static_cast<int>(operation.value))) {
+            return false;
+        }
+        undo.push_back([this, key, previous]() {
+            AirplaneHandle handle = findAirplaneHandleById(key);
+            airplanes_.get(handle)->setTotalFlightHours(previous);
+            publishAirplaneAt(airplanes_.denseIndexOf(handle));
+        });
+        return true;
+    }
+    case FleetTransaction::SET_AIRPLANE_BASE: {
+        const Airplane *airplane = airplanes_.get(findAirplaneHandleById(key));
+        if (airplane == nullptr) {
+            return false;
+        }
+        string previous = airplane->getBaseAirportCodeRef();
+        if (!setAirplaneBase(key, operation.text)) {
+            return false;
+        }
+        undo.push_back([this, key, previous]() { setAirplaneBase(key, previous); });
+        return true;
+    }
+    case FleetTransaction::ADD_DESTINATION:
+        if (!addDestination(transaction.getDestination(operation.item))) {
+            return false;
+        }
+        undo.push_back([this, key]() { removeDestinationByCode(key); });
+        return true;
+    case FleetTransaction::REMOVE_DESTINATION: {
+        const Destination *destination = destinations_.get(findDestinationHandleByCode(key));
+        if (destination == nullptr) {
+            return false;
+        }
+        Destination removed(*destination);
+        if (!removeDestinationByCode(key)) {
+            return false;
+        }
+        undo.push_back([this, removed]() { addDestination(removed); });
+        return true;
+    }
+    case FleetTransaction::SET_DESTINATION_RUNWAY: {
+        const Destination *destination = destinations_.get(findDestinationHandleByCode(key));
+        if (destination == nullptr) {
+            return false;
+        }
+        double previous = destination->getRunwayLengthMeters();
+        if (!setDestinationRunwayLength(key, operation.value)) {
+            return false;
+        }
+        undo.push_back([this, key, previous]() { setDestinationRunwayLength(key, previous); });
+        return true;
+    }
+    }
+    return false;
+}
 
-    Destination *dest = findDestinationByCode(destinationCode);
-    if (dest == nullptr) {
-        return compatibleAirplanes;
+void FleetManager::erasePlaneClass(const string &classId) {
+    PlaneClassHandle handle = findPlaneClassHandleById(classId);
+    const shared_ptr<const PlaneClass> *planeClass = planeClasses_.get(handle);
+    if (planeClass == nullptr) {
+        return;
     }
+    airplanesByClass_.erase(planeClass->get());
+    planeClasses_.erase(handle);
+    planeClassIndexById_.erase(classId);
+    planeClassRangeIndexDirty_ = true;
+    routePlanner_.reset();
+    snapshotDirty_ = true;
+}
 
-    for (auto &airplane : airplanes_) {
-        if (airplane.canFlyToDestination(dest->getRunwayLengthMeters(),
-                                         dest->getDistanceFromBaseKm())) {
-            compatibleAirplanes.push_back(&airplane);
-        }
+AirplaneHandle FleetManager::findAirplaneHandleById(const string &id) const {
+    auto found = airplaneIndexById_.find(id);
+    return found == airplaneIndexById_.end() ? AirplaneHandle() : found->second;
+}
+
+DestinationHandle FleetManager::findDestinationHandleByCode(const string &code) const {
+    auto found = destinationIndexByCode_.find(code);
+    return found == destinationIndexByCode_.end() ? DestinationHandle() : found->second;
+}
+
+PlaneClassHandle FleetManager::findPlaneClassHandleById(const string &classId) const {
+    auto found = planeClassIndexById_.find(classId);
+    return found == planeClassIndexById_.end() ? PlaneClassHandle() : found->second;
+}
+
+const Airplane *FleetManager::getAirplane(AirplaneHandle handle) const {
+    return airplanes_.get(handle);
+}
+
+const Destination *FleetManager::getDestination(DestinationHandle handle) const {
+    return destinations_.get(handle);
+}
+
+const PlaneClass *FleetManager::getPlaneClass(PlaneClassHandle handle) const {
+    const shared_ptr<const PlaneClass> *planeClass = planeClasses_.get(handle);
+    return planeClass == nullptr ? nullptr : planeClass->get();
+}
+
+shared_ptr<const PlaneClass> FleetManager::getSharedPlaneClass(PlaneClassHandle handle) const {
+    const shared_ptr<const PlaneClass> *planeClass = planeClasses_.get(handle);
+    return planeClass == nullptr ? shared_ptr<const PlaneClass>() : *planeClass;
+}
+
+shared_ptr<const PlaneClass> FleetManager::findSharedPlaneClass(const string &classId) const {
+    const shared_ptr<const PlaneClass> *planeClass = planeClasses_.get(findPlaneClassHandleById(classId));
+    return planeClass == nullptr ? shared_ptr<const PlaneClass>() : *planeClass;
+}
+
+const Airplane *FleetManager::findAirplaneById(const string &id) const {
+    return airplanes_.get(findAirplaneHandleById(id));
+}
+
+const Destination *FleetManager::findDestinationByCode(const string &code) const {
+    return destinations_.get(findDestinationHandleByCode(code));
+}
+
+const PlaneClass *FleetManager::findPlaneClassById(const string &classId) const {
+    return getPlaneClass(findPlaneClassHandleById(classId));
+}
+
+vector<const Airplane *> FleetManager::findAirplanesForDestination(
+    const string &destinationCode) const {
+    vector<const Airplane *> compatibleAirplanes;
+    for (AirplaneHandle handle : findAirplaneHandlesForDestination(destinationCode)) {
+        compatibleAirplanes.push_back(airplanes_.get(handle));
     }
     return compatibleAirplanes;
 }
 
-vector<Airplane *> FleetManager::findCompatibleAirplanes(double runwayLength, double distance) {
-    vector<Airplane *> compatibleAirplanes;
-    for (auto &airplane : airplanes_) {
-        if (airplane.canFlyToDestination(runwayLength, distance)) {
-            compatibleAirplanes.push_back(&airplane);
-        }
+vector<const Airplane *> FleetManager::findCompatibleAirplanes(double runwayLength,
+                                                               double distance) const {
+    vector<uint32_t> positions;
+    compatibilityIndex_.findCompatible(runwayLength, distance, positions);
+
+    vector<const Airplane *> compatibleAirplanes;
+    compatibleAirplanes.reserve(positions.size());
+    const vector<Airplane> &airplanes = airplanes_.values();
+    for (uint32_t position : positions) {
+        compatibleAirplanes.push_back(&airplanes[position]);
     }
     return compatibleAirplanes;
 }
 
-vector<Airplane *> FleetManager::getOperationalAirplanes() {
-    vector<Airplane *> operationalAirplanes;
-    for (auto &airplane : airplanes_) {
-        if (airplane.isOperational()) {
-            operationalAirplanes.push_back(&airplane);
-        }
+vector<const Airplane *> FleetManager::getOperationalAirplanes() const {
+    vector<const Airplane *> operationalAirplanes;
+    for (AirplaneHandle handle : getOperationalAirplaneHandles()) {
+        operationalAirplanes.push_back(airplanes_.get(handle));
     }
     return operationalAirplanes;
 }
 
-void FleetManager::displayAllAirplanes(ostream &os) const {
-    os << "\nСАМОЛЕТИ ВЪВ ФЛОТА" << endl;
-    os << "Общ брой самолети: " << airplanes_.size() << "\n" << endl;
+vector<AirplaneHandle> FleetManager::findAirplaneHandlesForDestination(
+    const string &destinationCode) const {
+    lock_guard<recursive_mutex> lock(writeMutex_);
+    DestinationHandle handle = findDestinationHandleByCode(destinationCode);
+    if (destinations_.get(handle) == nullptr) {
+        return vector<AirplaneHandle>();
+    }
+    enableViews();
+    return views_.getAirplanesForDestination(handle);
+}
 
-    if (airplanes_.empty()) {
-        os << "Няма самолети във флота." << endl;
-        return;
+void FleetManager::computeBaseDistances(const Destination &destination, double *distances) const {
+    for (size_t base = 0; base < compatibilityIndex_.getBaseAirportCount(); ++base) {
+        const Destination *airport = destinations_.get(
+            findDestinationHandleByCode(compatibilityIndex_.getBaseAirportCode(base)));
+        distances[base] = distanceCache_.getDistanceFromAirportKm(airport, destination);
     }
+}
 
-    int count = 1;
-    for (const auto &airplane : airplanes_) {
-        os << "[" << count++ << "] ";
-        os << airplane << endl;
+vector<double> FleetManager::computeRouteBaseDistances(
+    const vector<const Destination *> &destinations, const vector<string> &baseAirportCodes) const {
+    vector<const Destination *> baseAirports;
+    baseAirports.reserve(baseAirportCodes.size());
+    for (const auto &code : baseAirportCodes) {
+        baseAirports.push_back(destinations_.get(findDestinationHandleByCode(code)));
+    }
+    size_t baseAirportCount = baseAirports.size();
+    vector<double> distances(destinations.size() * baseAirportCount, 0.0);
+    for (size_t route = 0; route < destinations.size(); ++route) {
+        if (destinations[route] == nullptr) {
+            continue;
+        }
+        for (size_t base = 0; base < baseAirportCount; ++base) {
+            distances[route * baseAirportCount + base] =
+                distanceCache_.getDistanceFromAirportKm(baseAirports[base], *destinations[route]);
+        }
     }
+    return distances;
 }
 
-void FleetManager::displayAllDestinations(ostream &os) const {
-    os << "\nДЕСТИНАЦИИ" << endl;
-    os << "Общ брой дестинации: " << destinations_.size() << "\n" << endl;
+vector<DestinationHandle> FleetManager::findDestinationHandlesWithinKm(const string &code,
+                                                                       double radiusKm) const {
+    lock_guard<recursive_mutex> lock(writeMutex_);
+    vector<DestinationHandle> nearby;
+    const Destination *center = destinations_.get(findDestinationHandleByCode(code));
+    if (center == nullptr || !center->hasCoordinates()) {
+        return nearby;
+    }
+    if (!geoIndex_) {
+        geoIndex_.reset(new GeoIndex(destinations_.values()));
+    }
+    vector<uint32_t> positions;
+    geoIndex_->findWithinKm(*center, radiusKm, positions);
+
+    vector<pair<double, uint32_t> > byDistance;
+    const vector<Destination> &destinations = destinations_.values();
+    for (uint32_t position : positions) {
+        const Destination &destination = destinations[position];
+        if (destination.getCodeRef() == code) {
+            continue;
+        }
+        double distance = distanceCache_.getDistanceFromAirportKm(center, destination);
+        if (distance <= radiusKm) {
+            byDistance.push_back(make_pair(distance, position));
+        }
+    }
+    sort(byDistance.begin(), byDistance.end());
+    nearby.reserve(byDistance.size());
+    for (const auto &entry : byDistance) {
+        nearby.push_back(destinations_.handleAt(entry.second));
+    }
+    return nearby;
+}
 
-    if (destinations_.empty()) {
-        os << "Няма регистрирани дестинации." << endl;
+vector<AirplaneHandle> FleetManager::findCompatibleAirplaneHandles(double runwayLength,
+                                                                   double distance) const {
+    vector<uint32_t> positions;
+    compatibilityIndex_.findCompatible(runwayLength, distance, positions);
+
+    vector<AirplaneHandle> compatibleAirplanes;
+    compatibleAirplanes.reserve(positions.size());
+    for (uint32_t position : positions) {
+        compatibleAirplanes.push_back(airplanes_.handleAt(position));
+    }
+    return compatibleAirplanes;
+}
+
+vector<AirplaneHandle> FleetManager::getOperationalAirplaneHandles() const {
+    lock_guard<recursive_mutex> lock(writeMutex_);
+    enableViews();
+    return views_.getOperationalAirplanes();
+}
+
+void FleetManager::enableViews() const {
+    if (viewsEnabled_) {
         return;
     }
+    viewsEnabled_ = true;
+    views_.clear();
+    const vector<Airplane> &airplanes = airplanes_.values();
+    for (size_t i = 0; i < airplanes.size(); ++i) {
+        views_.setOperational(airplanes_.handleAt(i), airplanes[i].isOperational());
+    }
+    for (size_t i = 0; i < destinations_.size(); ++i) {
+        addDestinationToViews(destinations_.handleAt(i));
+    }
+}
 
-    int count = 1;
-    for (const auto &destination : destinations_) {
-        os << "[" << count++ << "] ";
-        os << destination << endl;
+void FleetManager::addAirplaneToViews(AirplaneHandle handle) const {
+    const Airplane *airplane = airplanes_.get(handle);
+    views_.setOperational(handle, airplane->isOperational());
+    if (!airplane->isOperational()) {
+        return;
+    }
+    const PlaneClass &planeClass = airplane->getPlaneClassRef();
+    const Destination *base =
+        destinations_.get(findDestinationHandleByCode(airplane->getBaseAirportCodeRef()));
+    const vector<Destination> &destinations = destinations_.values();
+    for (size_t i = 0; i < destinations.size(); ++i) {
+        const Destination &destination = destinations[i];
+        if (planeClass.isCompatibleWithRunway(destination.getRunwayLengthMeters()) &&
+            distanceCache_.getDistanceFromAirportKm(base, destination) <=
+                planeClass.calculateMaxRange()) {
+            views_.link(destinations_.handleAt(i), handle);
+        }
+    }
+}
+
+void FleetManager::removeAirplaneFromViews(AirplaneHandle handle) const {
+    views_.setOperational(handle, false);
+    views_.unlinkAirplane(handle);
+}
+
+void FleetManager::addDestinationToViews(DestinationHandle handle) const {
+    const Destination *destination = destinations_.get(handle);
+    vector<double> baseDistances(compatibilityIndex_.getBaseAirportCount());
+    computeBaseDistances(*destination, baseDistances.data());
+    vector<uint32_t> positions;
+    compatibilityIndex_.findCompatible(destination->getRunwayLengthMeters(),
+                                       baseDistances.data(), positions);
+    for (uint32_t position : positions) {
+        views_.link(handle, airplanes_.handleAt(position));
+    }
+}
+
+// Разстоянията от базата зависят от това дали летището е регистрирано и
+// има ли координати, затова при добавянето или премахването му самолетите
+// с тази база се подреждат наново.
+void FleetManager::refreshAirplanesBasedAt(const string &code) const {
+    const vector<Airplane> &airplanes = airplanes_.values();
+    for (size_t i = 0; i < airplanes.size(); ++i) {
+        if (airplanes[i].getBaseAirportCodeRef() == code) {
+            removeAirplaneFromViews(airplanes_.handleAt(i));
+            addAirplaneToViews(airplanes_.handleAt(i));
+        }
     }
 }
 
+CompatibilityMatrix FleetManager::buildCompatibilityMatrix(unsigned threadCount) const {
+    lock_guard<recursive_mutex> lock(writeMutex_);
+    // Разстоянията се пресмятат преди разделянето между нишки, защото
+    // кешът с разстояния не е защитен за паралелен достъп.
+    const vector<Destination> &destinations = destinations_.values();
+    size_t baseAirportCount = compatibilityIndex_.getBaseAirportCount();
+    vector<double> baseDistances(destinations.size() * baseAirportCount);
+    for (size_t row = 0; row < destinations.size(); ++row) {
+        computeBaseDistances(destinations[row], baseDistances.data() + row * baseAirportCount);
+    }
+    CompatibilityMatrix matrix = CompatibilityMatrix::compute(compatibilityIndex_, destinations,
+                                                              baseDistances, threadCount);
+
+    vector<DestinationHandle> destinationHandles;
+    destinationHandles.reserve(destinations_.size());
+    for (size_t i = 0; i < destinations_.size(); ++i) {
+        destinationHandles.push_back(destinations_.handleAt(i));
+    }
+    matrix.setHandles(destinationHandles, getDenseAirplaneHandles());
+    return matrix;
+}
+
+vector<AirplaneHandle> FleetManager::getDenseAirplaneHandles() const {
+    vector<AirplaneHandle> airplaneHandles;
+    airplaneHandles.reserve(airplanes_.size());
+    for (size_t i = 0; i < airplanes_.size(); ++i) {
+        airplaneHandles.push_back(airplanes_.handleAt(i));
+    }
+    return airplaneHandles;
+}
+
+vector<const Destination *> FleetManager::findRouteDestinations(
+    const vector<RouteRequest> &routes) const {
+    vector<const Destination *> destinations;
+    destinations.reserve(routes.size());
+    for (const auto &route : routes) {
+        auto found = destinationIndexByCode_.find(route.destinationCode);
+        destinations.push_back(found == destinationIndexByCode_.end()
+                                   ? nullptr
+                                   : destinations_.get(found->second));
+    }
+    return destinations;
+}
+
+RouteCostEngine FleetManager::buildRouteCostEngine() const {
+    return RouteCostEngine(airplanes_.values(), getDenseAirplaneHandles());
+}
+
+vector<RouteAssignment> FleetManager::planRoutes(const vector<RouteRequest> &routes,
+                                                 unsigned threadCount) const {
+    lock_guard<recursive_mutex> lock(writeMutex_);
+    // Разстоянията се пресмятат преди разделянето между нишки, защото
+    // кешът с разстояния не е защитен за паралелен достъп.
+    RouteCostEngine engine = buildRouteCostEngine();
+    vector<const Destination *> destinations = findRouteDestinations(routes);
+    return engine.assignCheapest(
+        destinations, routes, computeRouteBaseDistances(destinations, engine.getBaseAirportCodes()),
+        threadCount);
+}
+
+FleetAssignment FleetManager::assignFleet(const vector<RouteRequest> &routes) const {
+    lock_guard<recursive_mutex> lock(writeMutex_);
+    FleetAssignmentOptimizer optimizer(airplanes_.values(), getDenseAirplaneHandles());
+    vector<const Destination *> destinations = findRouteDestinations(routes);
+    return optimizer.assign(
+        destinations, routes,
+        computeRouteBaseDistances(destinations, optimizer.getBaseAirportCodes()));
+}
+
+FlightPlan FleetManager::planFlight(const string &classId, const string &originCode,
+                                    const string &targetCode, RoutingObjective objective) const {
+    lock_guard<recursive_mutex> lock(writeMutex_);
+    const shared_ptr<const PlaneClass> planeClass = findSharedPlaneClass(classId);
+    if (!planeClass) {
+        FlightPlan plan;
+        plan.status = FLIGHT_UNKNOWN_CLASS;
+        plan.totalDistanceKm = 0.0;
+        plan.totalFuelLiters = 0.0;
+        return plan;
+    }
+    if (!routePlanner_) {
+        routePlanner_.reset(new RoutePlanner(destinations_.values()));
+    }
+    return routePlanner_->planFlight(*planeClass, originCode, targetCode, objective);
+}
+
+vector<PlaneClassHandle> FleetManager::findCompatiblePlaneClasses(double runwayLength,
+                                                                 double distance) const {
+    lock_guard<recursive_mutex> lock(writeMutex_);
+    if (planeClassRangeIndexDirty_) {
+        planeClassRangeIndex_.rebuild(planeClasses_.values());
+        planeClassRangeIndexDirty_ = false;
+    }
+    vector<uint32_t> positions;
+    planeClassRangeIndex_.findCompatible(runwayLength, distance, positions);
+
+    vector<PlaneClassHandle> compatibleClasses;
+    compatibleClasses.reserve(positions.size());
+    for (uint32_t position : positions) {
+        compatibleClasses.push_back(planeClasses_.handleAt(position));
+    }
+    return compatibleClasses;
+}
+
+vector<AirplaneHandle> FleetManager::findOperationalAirplanesByClass(double runwayLength,
+                                                                     double distance) const {
+    vector<AirplaneHandle> compatibleAirplanes;
+    for (PlaneClassHandle classHandle : findCompatiblePlaneClasses(runwayLength, distance)) {
+        auto members = airplanesByClass_.find(getPlaneClass(classHandle));
+        if (members == airplanesByClass_.end()) {
+            continue;
+        }
+        for (AirplaneHandle handle : members->second) {
+            if (airplanes_.get(handle)->isOperational()) {
+                compatibleAirplanes.push_back(handle);
+            }
+        }
+    }
+    return compatibleAirplanes;
+}
+
+void FleetManager::displayAllAirplanes(ostream &os) const {
+    takeSnapshot()->displayAllAirplanes(os);
+}
+
+void FleetManager::displayAllDestinations(ostream &os) const {
+    takeSnapshot()->displayAllDestinations(os);
+}
+
 void FleetManager::displayAllPlaneClasses(ostream &os) const {
-    os << "\nКЛАСОВЕ САМОЛЕТИ" << endl;
-    os << "Общ брой класове: " << planeClasses_.size() << "\n" << endl;
+    takeSnapshot()->displayAllPlaneClasses(os);
+}
 
-    if (planeClasses_.empty()) {
-        os << "Няма регистрирани класове самолети." << endl;
-        return;
+bool FleetManager::savePlaneClassesToFile(const string &filename,
+                                          unsigned long generation) const {
+    ostringstream file;
+    file << GENERATION_PREFIX << generation << '\n';
+    for (const auto &pc : planeClasses_.values()) {
+        file << pc->getManufacturer() << "\t" << pc->getModel() << "\t"
+             << pc->getSeatCount() << "\t" << pc->getMinRunwayLength() << "\t"
+             << pc->getFuelConsumptionPerKmPerSeat() << "\t"
+             << pc->getTankVolumeLiters() << "\t" << pc->getAverageSpeedKmh()
+             << "\t" << pc->getRequiredCrewCount() << '\n';
     }
+    return writeFileDurably(filename, file.str());
+}
 
-    int count = 1;
-    for (const auto &planeClass : planeClasses_) {
-        os << "[" << count++ << "] ";
-        os << planeClass << endl;
+bool FleetManager::saveAirplanesToFile(const string &filename, unsigned long generation) const {
+    ostringstream file;
+    file << GENERATION_PREFIX << generation << '\n';
+    for (const auto &airplane : airplanes_.values()) {
+        file << airplane.getIdentificationNumberRef() << "\t"
+             << airplane.getPlaneClassRef().getClassIdRef() << "\t"
+             << (airplane.isOperational() ? 1 : 0) << "\t"
+             << airplane.getBaseAirportCodeRef() << "\t"
+             << airplane.getTotalFlightHours() << '\n';
     }
+    return writeFileDurably(filename, file.str());
 }
 
-bool FleetManager::savePlaneClassesToFile(const string &filename) const {
-    ofstream file(filename);
-    if (!file.is_open()) {
-        return false;
+bool FleetManager::saveDestinationsToFile(const string &filename,
+                                          unsigned long generation) const {
+    ostringstream file;
+    file << GENERATION_PREFIX << generation << '\n';
+    // Шест значещи цифри не стигат за координатите.
+    file << setprecision(10);
+    for (const auto &dest : destinations_.values()) {
+        file << dest.getCodeRef() << "\t" << dest.getName() << "\t" << dest.getCity()
+             << "\t" << dest.getCountry() << "\t" << dest.getRunwayLengthMeters()
+             << "\t" << dest.getDistanceFromBaseKm();
+        if (dest.hasCoordinates()) {
+            file << "\t" << dest.getLatitude() << "\t" << dest.getLongitude();
+        }
+        file << '\n';
     }
+    return writeFileDurably(filename, file.str());
+}
+
+vector<string> FleetManager::getDataFilePaths() const {
+    return {dataDirectory_ + "/plane_classes.txt", dataDirectory_ + "/airplanes.txt",
+            dataDirectory_ + "/destinations.txt"};
+}
 
-    for (const auto &pc : planeClasses_) {
-        file << pc.getManufacturer() << " " << pc.getModel() << " "
-             << pc.getSeatCount() << " " << pc.getMinRunwayLength() << " "
-             << pc.getFuelConsumptionPerKmPerSeat() << " "
-             << pc.getTankVolumeLiters() << " " << pc.getAverageSpeedKmh()
-             << " " << pc.getRequiredCrewCount() << endl;
+unsigned long FleetManager::readCommittedGeneration() const {
+    ifstream file(dataDirectory_ + "/generation");
+    unsigned long generation = 0;
+    if (!(file >> generation)) {
+        return 0;
     }
-    file.close();
-    return true;
+    return generation;
 }
 
-bool FleetManager::loadPlaneClassesFromFile(const string &filename) {
+unsigned long FleetManager::readFileGeneration(const string &filename) {
     ifstream file(filename);
-    if (!file.is_open()) {
-        return false;
+    string header;
+    if (!getline(file, header) ||
+        header.compare(0, GENERATION_PREFIX.size(), GENERATION_PREFIX) != 0) {
+        return 0;
+    }
+    istringstream value(header.substr(GENERATION_PREFIX.size()));
+    unsigned long generation = 0;
+    value >> generation;
+    return generation;
+}
+
+unsigned long FleetManager::readSnapshotGeneration(const string &filename) {
+    ifstream file(filename, ios::binary);
+    SnapshotHeader header;
+    if (!file.read(reinterpret_cast<char *>(&header), sizeof(header)) ||
+        memcmp(header.magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC)) != 0) {
+        return 0;
     }
+    return header.generation;
+}
 
-    PlaneClass pc;
-    while (file >> pc) {
-        if (!pc.getManufacturer().empty()) {
-            addPlaneClass(pc);
+bool FleetManager::recoverInterruptedSave(unsigned long committedGeneration) const {
+    vector<string> paths = getDataFilePaths();
+    paths.push_back(getSnapshotFilePath());
+    for (const auto &path : paths) {
+        string temporaryPath = path + ".tmp";
+        if (!fileExists(temporaryPath)) {
+            continue;
+        }
+        unsigned long generation = path == getSnapshotFilePath()
+                                       ? readSnapshotGeneration(temporaryPath)
+                                       : readFileGeneration(temporaryPath);
+        if (committedGeneration != 0 && generation == committedGeneration) {
+            if (!renameDurably(temporaryPath, path)) {
+                return false;
+            }
+        } else {
+            remove(temporaryPath.c_str());
         }
     }
-    file.close();
     return true;
 }
 
-bool FleetManager::saveAirplanesToFile(const string &filename) const {
-    ofstream file(filename);
-    if (!file.is_open()) {
+bool FleetManager::saveAllData() const {
+    lock_guard<recursive_mutex> lock(writeMutex_);
+    vector<string> paths = getDataFilePaths();
+    unsigned long generation = readCommittedGeneration() + 1;
+
+    // Всичко, включително двоичното копие, се записва във временни файлове
+    // преди смяната на поколението и се премества на мястото си едва след
+    // нея; ако нещо се провали, старото поколение и журналът остават.
+    paths.push_back(getSnapshotFilePath());
+    bool written = savePlaneClassesToFile(paths[0] + ".tmp", generation) &&
+                   saveAirplanesToFile(paths[1] + ".tmp", generation) &&
+                   saveDestinationsToFile(paths[2] + ".tmp", generation) &&
+                   takeSnapshot()->saveBinary(paths[3] + ".tmp", generation);
+    if (!written || !replaceFileAtomically(dataDirectory_ + "/generation",
+                                           to_string(generation) + "\n")) {
+        for (const auto &path : paths) {
+            remove((path + ".tmp").c_str());
+        }
         return false;
     }
 
-    for (const auto &airplane : airplanes_) {
-        file << airplane.getIdentificationNumber() << "\t"
-             << airplane.getPlaneClassRef().getClassId() << "\t"
-             << (airplane.isOperational() ? 1 : 0) << "\t"
-             << airplane.getBaseAirportCode() << "\t"
-             << airplane.getTotalFlightHours() << endl;
+    // След смяната новото поколение е записано, дори преименуването да се
+    // провали: следващото зареждане го довършва. Затова журналът минава на
+    // новото поколение и тогава, иначе записите след този момент биха се
+    // пропуснали при зареждане като остарели.
+    bool renamed = recoverInterruptedSave(generation);
+    bool journalReset = !journal_ || journal_->reset(generation);
+    return renamed && journalReset;
+}
+
+bool FleetManager::loadAllData() {
+    WriteScope scope(*this);
+    // Зарежда се във временен флот, който замества текущия само при успех.
+    // Иначе неуспешно зареждане би оставило празен флот, а следващото
+    // свиване на журнала би го записало върху добрите файлове.
+    FleetManager loaded(companyName_, dataDirectory_);
+    bool succeeded = loaded.loadFromFiles();
+    lastLoadErrors_ = move(loaded.lastLoadErrors_);
+    if (succeeded) {
+        adoptFleetData(loaded);
     }
-    file.close();
-    return true;
+    return succeeded;
 }
 
-bool FleetManager::loadAirplanesFromFile(const string &filename) {
-    ifstream file(filename);
-    if (!file.is_open()) {
+bool FleetManager::loadFromFiles() {
+    WriteScope scope(*this);
+    lastLoadErrors_.clear();
+    unsigned long generation = readCommittedGeneration();
+    if (!recoverInterruptedSave(generation)) {
         return false;
     }
-
-    string line;
-    while (getline(file, line)) {
-        if (line.empty()) {
-            continue;
+    if (generation != 0) {
+        for (const auto &path : getDataFilePaths()) {
+            if (readFileGeneration(path) != generation) {
+                return false;
+            }
         }
+    }
+
+    vector<string> paths = getDataFilePaths();
+    LoadedFleetData data = FleetLoader::load(paths[0], paths[1], paths[2], 0);
+
+    ++journalSuppressionDepth_;
+    mergeLoadedData(data, paths[1]);
+    lastLoadErrors_ = move(data.errors);
+    replayJournal(getJournalFilePath(), generation);
+    --journalSuppressionDepth_;
+    return true;
+}
+
+void FleetManager::adoptFleetData(FleetManager &loaded) {
+    airplanes_ = move(loaded.airplanes_);
+    destinations_ = move(loaded.destinations_);
+    planeClasses_ = move(loaded.planeClasses_);
+    airplaneIndexById_ = move(loaded.airplaneIndexById_);
+    destinationIndexByCode_ = move(loaded.destinationIndexByCode_);
+    planeClassIndexById_ = move(loaded.planeClassIndexById_);
+    compatibilityIndex_ = move(loaded.compatibilityIndex_);
+    planeClassRangeIndex_ = move(loaded.planeClassRangeIndex_);
+    planeClassRangeIndexDirty_ = loaded.planeClassRangeIndexDirty_;
+    airplanesByClass_ = move(loaded.airplanesByClass_);
+
+    routePlanner_.reset();
+    geoIndex_.reset();
+    distanceCache_.clear();
+    views_.clear();
+    viewsEnabled_ = false;
+    if (publishingEnabled_) {
+        rebuildPublishedState();
+    }
+    snapshotDirty_ = true;
 
-        istringstream iss(line);
-        string id, planeClassId, baseAirport;
-        int operational, flightHours;
+    // За абонатите подмяната изглежда като изчистване и добавяне наново.
+    notifyChange(FLEET_CLEARED, "");
+    if (!subscribers_.empty()) {
+        for (const auto &planeClass : planeClasses_.values()) {
+            notifyChange(PLANE_CLASS_ADDED, planeClass->getClassIdRef());
+        }
+        for (const auto &airplane : airplanes_.values()) {
+            notifyChange(AIRPLANE_ADDED, airplane.getIdentificationNumberRef());
+        }
+        for (const auto &destination : destinations_.values()) {
+            notifyChange(DESTINATION_ADDED, destination.getCodeRef());
+        }
+    }
+}
 
-        if (!getline(iss, id, '\t')) continue;
-        if (!getline(iss, planeClassId, '\t')) continue;
+const vector<LoadError> &FleetManager::getLastLoadErrors() const { return lastLoadErrors_; }
 
-        string operationalStr, flightHoursStr;
-        if (!getline(iss, operationalStr, '\t')) continue;
-        if (!getline(iss, baseAirport, '\t')) continue;
-        if (!getline(iss, flightHoursStr)) continue;
+void FleetManager::displayLoadErrors(ostream &os) const {
+    if (lastLoadErrors_.empty()) {
+        return;
+    }
+    os << "Пропуснати невалидни редове: " << lastLoadErrors_.size() << endl;
+    for (const auto &error : lastLoadErrors_) {
+        os << "  " << error.filename << ":" << error.lineNumber << " - " << error.reason << endl;
+    }
+}
 
-        operational = stoi(operationalStr);
-        flightHours = stoi(flightHoursStr);
+void FleetManager::mergeLoadedData(LoadedFleetData &data, const string &airplanesFile) {
+    planeClasses_.reserve(planeClasses_.size() + data.planeClasses.size());
+    for (const auto &planeClass : data.planeClasses) {
+        addPlaneClass(planeClass);
+    }
 
-        PlaneClass *pc = findPlaneClassById(planeClassId);
-        if (pc == nullptr) {
+    airplanes_.reserve(airplanes_.size() + data.airplanes.size());
+    airplaneIndexById_.reserve(airplanes_.size() + data.airplanes.size());
+    for (auto &row : data.airplanes) {
+        shared_ptr<const PlaneClass> pc = findSharedPlaneClass(row.planeClassId);
+        if (!pc) {
+            data.errors.push_back(
+                LoadError{airplanesFile, row.lineNumber, "непознат клас самолет"});
             continue;
         }
-        Airplane airplane(id, *pc, operational == 1, baseAirport, flightHours);
-        addAirplane(airplane);
+        try {
+            if (!insertAirplane(Airplane(move(row.identificationNumber), pc, row.operational,
+                                         move(row.baseAirportCode), row.totalFlightHours),
+                                pc)) {
+                data.errors.push_back(
+                    LoadError{airplanesFile, row.lineNumber, "повтарящ се номер на самолет"});
+            }
+        } catch (const exception &e) {
+            data.errors.push_back(LoadError{airplanesFile, row.lineNumber, e.what()});
+        }
+    }
+
+    destinations_.reserve(destinations_.size() + data.destinations.size());
+    destinationIndexByCode_.reserve(destinations_.size() + data.destinations.size());
+    for (auto &destination : data.destinations) {
+        addDestination(move(destination));
     }
-    file.close();
-    return true;
 }
 
-bool FleetManager::saveDestinationsToFile(const string &filename) const {
-    ofstream file(filename);
-    if (!file.is_open()) {
+string FleetManager::getJournalFilePath() const { return dataDirectory_ + "/fleet.journal"; }
+
+bool FleetManager::enableJournal(size_t compactionThreshold) {
+    WriteScope scope(*this);
+    journal_.reset(new FleetJournal(getJournalFilePath()));
+    journalCompactionThreshold_ = compactionThreshold;
+    if (!journal_->open(readCommittedGeneration())) {
+        journal_.reset();
         return false;
     }
+    journal_->setAutoFlush(bulkUpdateDepth_ == 0);
+    return true;
+}
 
-    for (const auto &dest : destinations_) {
-        file << dest.getCode() << "\t" << dest.getName() << "\t" << dest.getCity()
-             << "\t" << dest.getCountry() << "\t" << dest.getRunwayLengthMeters()
-             << "\t" << dest.getDistanceFromBaseKm() << endl;
+void FleetManager::disableJournal() {
+    WriteScope scope(*this);
+    journal_.reset();
+}
+
+bool FleetManager::discardJournal() {
+    WriteScope scope(*this);
+    if (journal_) {
+        return journal_->reset(readCommittedGeneration());
     }
-    file.close();
-    return true;
+    return remove(getJournalFilePath().c_str()) == 0;
 }
 
-bool FleetManager::loadDestinationsFromFile(const string &filename) {
-    ifstream file(filename);
-    if (!file.is_open()) {
-        return false;
+bool FleetManager::isJournalEnabled() const { return journal_ != nullptr; }
+
+shared_ptr<FleetChangeQueue> FleetManager::subscribe(size_t capacity) {
+    WriteScope scope(*this);
+    shared_ptr<FleetChangeQueue> queue = make_shared<FleetChangeQueue>(capacity);
+    subscribers_.push_back(queue);
+    return queue;
+}
+
+void FleetManager::unsubscribe(const shared_ptr<FleetChangeQueue> &queue) {
+    WriteScope scope(*this);
+    subscribers_.erase(remove(subscribers_.begin(), subscribers_.end(), queue),
+                       subscribers_.end());
+}
+
+void FleetManager::notifyChange(FleetChangeType type, const string &key) {
+    if (subscribers_.empty()) {
+        return;
     }
+    if (type == FLEET_CLEARED) {
+        // Абонатът така или иначе ще пресметне всичко наново.
+        pendingChanges_.clear();
+    }
+    pendingChanges_.push_back(FleetChange{type, key});
+}
 
-    string line;
-    while (getline(file, line)) {
-        if (line.empty()) {
-            continue;
-        }
+void FleetManager::flushChanges() {
+    if (pendingChanges_.empty()) {
+        return;
+    }
+    for (const auto &subscriber : subscribers_) {
+        subscriber->push(pendingChanges_);
+    }
+    pendingChanges_.clear();
+}
+
+bool FleetManager::isJournaling() const {
+    return journal_ != nullptr && journalSuppressionDepth_ == 0;
+}
+
+void FleetManager::recordChange(FleetChangeType type, const string &key, const string &record) {
+    notifyChange(type, key);
+    snapshotDirty_ = true;
+    if (!isJournaling()) {
+        return;
+    }
+    if (capturingRecords_) {
+        capturedRecords_.push_back(record);
+        return;
+    }
+    journal_->append(record);
+    if (bulkUpdateDepth_ == 0 && journalNeedsCompaction()) {
+        saveAllData();
+    }
+}
 
-        istringstream iss(line);
-        string code, name, city, country, runwayStr, distanceStr;
+bool FleetManager::journalNeedsCompaction() const {
+    if (journalCompactionThreshold_ == 0) {
+        return false;
+    }
+    // Пълното записване струва колкото целия флот, затова журналът се
+    // свива едва когато стане поне толкова дълъг, колкото са записите.
+    size_t fleetSize = airplanes_.size() + destinations_.size() + planeClasses_.size();
+    return journal_->getRecordCount() >= max(journalCompactionThreshold_, fleetSize);
+}
 
-        if (!getline(iss, code, '\t')) continue;
-        if (!getline(iss, name, '\t')) continue;
-        if (!getline(iss, city, '\t')) continue;
-        if (!getline(iss, country, '\t')) continue;
-        if (!getline(iss, runwayStr, '\t')) continue;
-        if (!getline(iss, distanceStr)) continue;
+string FleetManager::formatPlaneClassRecord(const string &tag, const PlaneClass &planeClass) {
+    ostringstream record;
+    record << setprecision(numeric_limits<double>::max_digits10) << tag << "\t"
+           << planeClass.getManufacturer() << "\t" << planeClass.getModel() << "\t"
+           << planeClass.getSeatCount() << "\t" << planeClass.getMinRunwayLength() << "\t"
+           << planeClass.getFuelConsumptionPerKmPerSeat() << "\t"
+           << planeClass.getTankVolumeLiters() << "\t" << planeClass.getAverageSpeedKmh()
+           << "\t" << planeClass.getRequiredCrewCount();
+    return record.str();
+}
 
-        double runwayLength = stod(runwayStr);
-        double distance = stod(distanceStr);
+bool FleetManager::replayJournal(const string &filename, unsigned long generation) {
+    vector<string> records;
+    vector<size_t> lineNumbers;
+    unsigned long journalGeneration = 0;
+    bool truncated = false;
+    if (!FleetJournal::readRecords(filename, journalGeneration, records, lineNumbers,
+                                   truncated)) {
+        return false;
+    }
+    if (journalGeneration != generation) {
+        // Записването е прекъснато след смяната на поколението, но преди
+        // изчистването на журнала: записите вече са във файловете.
+        return true;
+    }
 
-        Destination dest(code, name, city, country, runwayLength, distance);
-        addDestination(dest);
+    // Отхвърленият запис се докладва като лош ред във файл с данни; иначе
+    // следващото свиване на журнала би го загубило без следа.
+    ++journalSuppressionDepth_;
+    for (size_t i = 0; i < records.size(); ++i) {
+        try {
+            if (!applyJournalRecord(FleetJournal::splitRecord(records[i]))) {
+                lastLoadErrors_.push_back(LoadError{filename, lineNumbers[i],
+                                                    "записът не може да бъде приложен"});
+            }
+        } catch (const exception &e) {
+            lastLoadErrors_.push_back(LoadError{filename, lineNumbers[i], e.what()});
+        }
     }
-    file.close();
+    --journalSuppressionDepth_;
     return true;
 }
 
-bool FleetManager::saveAllData() const {
-    savePlaneClassesToFile(dataDirectory_ + "/plane_classes.txt");
-    saveAirplanesToFile(dataDirectory_ + "/airplanes.txt");
-    saveDestinationsToFile(dataDirectory_ + "/destinations.txt");
-    return true;
+bool FleetManager::applyJournalRecord(const vector<string> &fields) {
+    const string &tag = fields[0];
+    if ((tag == "C" || tag == "U") && fields.size() == 9) {
+        PlaneClass planeClass(fields[1], fields[2], journalInt(fields[3]), journalDouble(fields[4]),
+                              journalDouble(fields[5]), journalDouble(fields[6]), journalDouble(fields[7]),
+                              journalInt(fields[8]));
+        return tag == "C" ? addPlaneClass(planeClass) : updatePlaneClass(planeClass);
+    }
+    if (tag == "A" && fields.size() == 6) {
+        shared_ptr<const PlaneClass> planeClass = findSharedPlaneClass(fields[2]);
+        if (!planeClass) {
+            throw invalid_argument("непознат клас самолет");
+        }
+        return insertAirplane(Airplane(fields[1], planeClass, fields[3] == "1", fields[4],
+                                       journalInt(fields[5])),
+                              planeClass);
+    }
+    if (tag == "R" && fields.size() == 2) {
+        return removeAirplaneById(fields[1]);
+    }
+    if (tag == "O" && fields.size() == 3) {
+        return setAirplaneOperational(fields[1], fields[2] == "1");
+    }
+    if (tag == "H" && fields.size() == 3) {
+        return addAirplaneFlightHours(fields[1], journalInt(fields[2]));
+    }
+    if (tag == "B" && fields.size() == 3) {
+        return setAirplaneBase(fields[1], fields[2]);
+    }
+    if (tag == "D" && fields.size() == 7) {
+        return addDestination(Destination(fields[1], fields[2], fields[3], fields[4],
+                                          journalDouble(fields[5]), journalDouble(fields[6])));
+    }
+    if (tag == "D" && fields.size() == 9) {
+        return addDestination(Destination(fields[1], fields[2], fields[3], fields[4],
+                                          journalDouble(fields[5]), journalDouble(fields[6]), journalDouble(fields[7]),
+                                          journalDouble(fields[8])));
+    }
+    if (tag == "X" && fields.size() == 2) {
+        return removeDestinationByCode(fields[1]);
+    }
+    if (tag == "W" && fields.size() == 3) {
+        return setDestinationRunwayLength(fields[1], journalDouble(fields[2]));
+    }
+    return false;
 }
 
-bool FleetManager::loadAllData() {
-    loadPlaneClassesFromFile(dataDirectory_ + "/plane_classes.txt");
-    loadAirplanesFromFile(dataDirectory_ + "/airplanes.txt");
-    loadDestinationsFromFile(dataDirectory_ + "/destinations.txt");
+bool FleetManager::saveSnapshot(const string &filename) const {
+    return takeSnapshot()->saveBinary(filename);
+}
+
+bool FleetManager::loadSnapshot(const string &filename) {
+    WriteScope scope(*this);
+    ifstream file(filename, ios::binary | ios::ate);
+    if (!file.is_open()) {
+        return false;
+    }
+    streamsize size = file.tellg();
+    if (size < static_cast<streamsize>(sizeof(SnapshotHeader))) {
+        return false;
+    }
+    vector<char> buffer(static_cast<size_t>(size));
+    file.seekg(0);
+    if (!file.read(buffer.data(), size) || !validateSnapshot(buffer.data(), buffer.size())) {
+        return false;
+    }
+
+    const char *data = buffer.data();
+    const SnapshotHeader *header = reinterpret_cast<const SnapshotHeader *>(data);
+    const char *stringTable = data + header->stringTableOffset;
+    auto text = [stringTable](const SnapshotString &value) {
+        return string(stringTable + value.offset, value.length);
+    };
+
+    clearAllData();
+    ++journalSuppressionDepth_;
+    try {
+        companyName_ = text(header->companyName);
+        planeClasses_.reserve(header->planeClassCount);
+        airplanes_.reserve(header->airplaneCount);
+        destinations_.reserve(header->destinationCount);
+        airplaneIndexById_.reserve(header->airplaneCount);
+        destinationIndexByCode_.reserve(header->destinationCount);
+
+        const SnapshotPlaneClass *classRecords =
+            reinterpret_cast<const SnapshotPlaneClass *>(data + header->planeClassOffset);
+        vector<shared_ptr<const PlaneClass> > classesByIndex(header->planeClassCount);
+        for (uint32_t i = 0; i < header->planeClassCount; ++i) {
+            const SnapshotPlaneClass &record = classRecords[i];
+            PlaneClass planeClass(text(record.manufacturer), text(record.model),
+                                  record.seatCount, record.minRunwayLength,
+                                  record.fuelConsumptionPerKmPerSeat, record.tankVolumeLiters,
+                                  record.averageSpeedKmh, record.requiredCrewCount);
+            addPlaneClass(planeClass);
+            classesByIndex[i] = findSharedPlaneClass(planeClass.getClassIdRef());
+        }
+
+        const SnapshotAirplane *airplaneRecords =
+            reinterpret_cast<const SnapshotAirplane *>(data + header->airplaneOffset);
+        for (uint32_t i = 0; i < header->airplaneCount; ++i) {
+            const SnapshotAirplane &record = airplaneRecords[i];
+            const shared_ptr<const PlaneClass> &planeClass = classesByIndex[record.planeClassIndex];
+            insertAirplane(Airplane(text(record.identificationNumber), planeClass,
+                                    record.operational != 0, text(record.baseAirportCode),
+                                    record.totalFlightHours),
+                           planeClass);
+        }
+
+        const SnapshotDestination *destinationRecords =
+            reinterpret_cast<const SnapshotDestination *>(data + header->destinationOffset);
+        for (uint32_t i = 0; i < header->destinationCount; ++i) {
+            const SnapshotDestination &record = destinationRecords[i];
+            Destination destination(text(record.code), text(record.name), text(record.city),
+                                    text(record.country), record.runwayLengthMeters,
+                                    record.distanceFromBaseKm);
+            if (record.hasCoordinates != 0) {
+                destination.setCoordinates(record.latitude, record.longitude);
+            }
+            addDestination(move(destination));
+        }
+    } catch (const exception &) {
+        clearAllData();
+        --journalSuppressionDepth_;
+        return false;
+    }
+    --journalSuppressionDepth_;
     return true;
 }
 
 void FleetManager::clearAllData() {
+    WriteScope scope(*this);
     airplanes_.clear();
     destinations_.clear();
     planeClasses_.clear();
+    airplaneIndexById_.clear();
+    destinationIndexByCode_.clear();
+    planeClassIndexById_.clear();
+    compatibilityIndex_.clear();
+    planeClassRangeIndex_.clear();
+    planeClassRangeIndexDirty_ = false;
+    airplanesByClass_.clear();
+    clearPublishedState();
+    routePlanner_.reset();
+    geoIndex_.reset();
+    distanceCache_.clear();
+    views_.clear();
+    snapshotDirty_ = true;
+    notifyChange(FLEET_CLEARED, "");
 }
 
 ostream &operator<<(ostream &os, const FleetManager &manager) {
+    shared_ptr<const FleetSnapshot> snapshot = manager.takeSnapshot();
     os << "\nСИСТЕМА ЗА УПРАВЛЕНИЕ НА ФЛОТА" << endl;
-    os << "Име на компанията:   " << manager.companyName_ << endl;
+    os << "Име на компанията:   " << snapshot->getCompanyName() << endl;
     os << "Директория с данни:  " << manager.dataDirectory_ << endl;
-    os << "Общо класове:        " << manager.planeClasses_.size() << endl;
-    os << "Общо самолети:       " << manager.airplanes_.size() << endl;
-    os << "Общо дестинации:     " << manager.destinations_.size() << endl;
+    os << "Общо класове:        " << snapshot->getPlaneClasses().size() << endl;
+    os << "Общо самолети:       " << snapshot->getAirplanes().size() << endl;
+    os << "Оперативни самолети: " << manager.getOperationalAirplaneCount() << endl;
+    os << "Общо дестинации:     " << snapshot->getDestinations().size() << endl;
     return os;
 }
 
@@ -394,7 +1867,7 @@ void FleetManager::viewPlaneClassDetails() {
     displayAllPlaneClasses(cout);
 
     string classId = Validator::getValidString("Въведете ID на класа (Производител Модел): ");
-    PlaneClass* pc = findPlaneClassById(classId);
+    const PlaneClass* pc = findPlaneClassById(classId);
 
     if (pc == nullptr) {
         cout << "\nКласът самолет не е намерен." << endl;
@@ -464,7 +1937,7 @@ void FleetManager::viewAirplaneDetails() {
     }
 
     string id = Validator::getValidString("Въведете ID на самолета: ");
-    Airplane* airplane = findAirplaneById(id);
+    const Airplane* airplane = findAirplaneById(id);
 
     if (airplane == nullptr) {
         cout << "\nСамолетът не е намерен." << endl;
@@ -483,14 +1956,14 @@ void FleetManager::toggleOperationalStatus() {
     }
 
     string id = Validator::getValidString("Въведете ID на самолета: ");
-    Airplane* airplane = findAirplaneById(id);
+    const Airplane* airplane = findAirplaneById(id);
 
     if (airplane == nullptr) {
         cout << "Самолетът не е намерен." << endl;
         return;
     }
 
-    airplane->setOperational(!airplane->isOperational());
+    setAirplaneOperational(id, !airplane->isOperational());
     cout << "Оперативният статус е променен на: "
               << (airplane->isOperational() ? "Оперативен" : "Неоперативен") << endl;
 }
@@ -513,13 +1986,13 @@ void FleetManager::handleAirplaneMenu() {
                 try {
                     string id = Validator::getValidString("ID на самолета (регистрационен номер): ");
                     string classId = Validator::getValidString("ID на класа (Производител Модел): ");
-                    PlaneClass* pc = findPlaneClassById(classId);
-                    if (pc == nullptr) {
+                    shared_ptr<const PlaneClass> pc = findSharedPlaneClass(classId);
+                    if (!pc) {
                         cout << "Класът самолет не е намерен." << endl;
                         break;
                     }
                     string baseAirport = Validator::getValidString("Код на базовото летище: ");
-                    Airplane newAirplane(id, *pc, true, baseAirport, 0);
+                    Airplane newAirplane(id, pc, true, baseAirport, 0);
                     if (!addAirplane(newAirplane)) {
                         cout << "\nНеуспешно добавяне. Самолетът вероятно вече съществува." << endl;
                     } else {
@@ -560,13 +2033,13 @@ void FleetManager::handleAirplaneMenu() {
                     break;
                 }
                 string id = Validator::getValidString("Въведете ID на самолета: ");
-                Airplane* airplane = findAirplaneById(id);
+                const Airplane* airplane = findAirplaneById(id);
                 if (airplane == nullptr) {
                     cout << "Самолетът не е намерен." << endl;
                     break;
                 }
                 int hours = Validator::getValidPositiveInt("Въведете брой часове за добавяне: ");
-                airplane->addFlightHours(hours);
+                addAirplaneFlightHours(id, hours);
                 cout << "Добавени " << hours << " летателни часа." << endl;
                 cout << "Общо летателни часове: " << airplane->getTotalFlightHours() << endl;
                 break;
@@ -587,7 +2060,7 @@ void FleetManager::viewDestinationDetails() {
     }
 
     string code = Validator::getValidString("Въведете код на дестинацията: ");
-    Destination* dest = findDestinationByCode(code);
+    const Destination* dest = findDestinationByCode(code);
 
     if (dest == nullptr) {
         cout << "\nДестинацията не е намерена." << endl;
@@ -615,6 +2088,12 @@ void FleetManager::handleDestinationMenu() {
                     double distance = Validator::getValidNonNegativeDouble("Разстояние от базата (км): ");
 
                     Destination newDest(code, name, city, country, runwayLength, distance);
+                    int withCoordinates = Validator::getValidInt("Въвеждане на координати? (1=Да, 0=Не): ");
+                    if (withCoordinates == 1) {
+                        double latitude = Validator::getValidDouble("Географска ширина (градуси): ");
+                        double longitude = Validator::getValidDouble("Географска дължина (градуси): ");
+                        newDest.setCoordinates(latitude, longitude);
+                    }
 
                     if (!addDestination(newDest)) {
                         cout << "\nНеуспешно добавяне. Дестинацията вероятно вече съществува." << endl;
@@ -647,6 +2126,21 @@ void FleetManager::handleDestinationMenu() {
                 }
                 break;
             }
+            case 5: {
+                if (getDestinationCount() == 0) {
+                    cout << "\nНяма регистрирани дестинации." << endl;
+                    break;
+                }
+                displayAllDestinations(cout);
+                string code = Validator::getValidString("Въведете код на дестинацията: ");
+                double length = Validator::getValidPositiveDouble("Нова дължина на пистата (метри): ");
+                if (!setDestinationRunwayLength(code, length)) {
+                    cout << "Дестинацията не е намерена." << endl;
+                } else {
+                    cout << "Дължината на пистата е променена." << endl;
+                }
+                break;
+            }
             case 0:
                 cout << "Връщане към главното меню..." << endl;
                 break;
@@ -669,7 +2163,7 @@ void FleetManager::searchAirplanesForDestination() {
     cout << "2. Търсене по дължина на пистата и разстояние" << endl;
     int searchChoice = Validator::getValidInt("Въведете избор: ");
 
-    vector<Airplane*> compatibleAirplanes;
+    vector<const Airplane*> compatibleAirplanes;
 
     if (searchChoice == 1) {
         if (getDestinationCount() == 0) {
@@ -680,7 +2174,7 @@ void FleetManager::searchAirplanesForDestination() {
         displayAllDestinations(cout);
         string code = Validator::getValidString("Въведете код на дестинацията: ");
 
-        Destination* dest = findDestinationByCode(code);
+        const Destination* dest = findDestinationByCode(code);
         if (dest == nullptr) {
             cout << "Дестинацията не е намерена." << endl;
             return;
@@ -690,12 +2184,15 @@ void FleetManager::searchAirplanesForDestination() {
         cout << "Писта: " << dest->getRunwayLengthMeters() << " м, Разстояние: "
                   << dest->getDistanceFromBaseKm() << " км" << endl;
 
+        // Ако летищата имат координати, разстоянието се смята от базата на
+        // всеки самолет.
         compatibleAirplanes = findAirplanesForDestination(code);
     } else {
         double runwayLength = Validator::getValidPositiveDouble("Въведете дължина на пистата (метри): ");
         double distance = Validator::getValidNonNegativeDouble("Въведете разстояние от базата (км): ");
-
-        compatibleAirplanes = findCompatibleAirplanes(runwayLength, distance);
+        for (AirplaneHandle handle : findOperationalAirplanesByClass(runwayLength, distance)) {
+            compatibleAirplanes.push_back(airplanes_.get(handle));
+        }
     }
 
     cout << "\nРЕЗУЛТАТИ ОТ ТЪРСЕНЕТО" << endl;
@@ -752,12 +2249,18 @@ void FleetManager::addSampleData() {
 
         cout << "Добавени 7 самолета." << endl;
 
-        Destination sofia("SOF", "Летище София", "София", "България", 3600.0, 0.0);
-        Destination varna("VAR", "Летище Варна", "Варна", "България", 2500.0, 380.0);
-        Destination london("LHR", "Heathrow Airport", "London", "UK", 3900.0, 2020.0);
-        Destination paris("CDG", "Charles de Gaulle", "Paris", "France", 4200.0, 1850.0);
-        Destination dubai("DXB", "Dubai International", "Dubai", "UAE", 4500.0, 4100.0);
-        Destination tokyo("NRT", "Narita International", "Tokyo", "Japan", 4000.0, 9100.0);
+        Destination sofia("SOF", "Летище София", "София", "България", 3600.0, 0.0,
+                          42.6952, 23.4062);
+        Destination varna("VAR", "Летище Варна", "Варна", "България", 2500.0, 380.0,
+                          43.2321, 27.8251);
+        Destination london("LHR", "Heathrow Airport", "London", "UK", 3900.0, 2020.0,
+                           51.4700, -0.4543);
+        Destination paris("CDG", "Charles de Gaulle", "Paris", "France", 4200.0, 1850.0,
+                          49.0097, 2.5479);
+        Destination dubai("DXB", "Dubai International", "Dubai", "UAE", 4500.0, 4100.0,
+                          25.2532, 55.3657);
+        Destination tokyo("NRT", "Narita International", "Tokyo", "Japan", 4000.0, 9100.0,
+                          35.7720, 140.3929);
         Destination smallIsland("ISL", "Small Island Strip", "Island", "Pacific", 1500.0, 2000.0);
 
         addDestination(sofia);
@@ -0,0 +1,231 @@
+#include "../headers/FleetSnapshot.h"
+#include "../headers/BinarySnapshot.h"
+#include "../headers/DurableFile.h"
+#include <cstdio>
+#include <cstring>
+
+using namespace std;
+
+FleetSnapshot::FleetSnapshot(unsigned long version, const string &companyName,
+                             const PersistentVector<Airplane> &airplanes,
+                             const PersistentVector<Destination> &destinations,
+                             const vector<shared_ptr<const PlaneClass> > &planeClasses,
+                             const PersistentMap<string, uint32_t> &airplanePositionById,
+                             const PersistentMap<string, uint32_t> &destinationPositionByCode,
+                             const SnapshotCompatibility &compatibility)
+    : version_(version), companyName_(companyName), airplanes_(airplanes),
+      destinations_(destinations), planeClasses_(planeClasses),
+      airplanePositionById_(airplanePositionById),
+      destinationPositionByCode_(destinationPositionByCode), compatibility_(compatibility) {}
+
+unsigned long FleetSnapshot::getVersion() const { return version_; }
+
+const string &FleetSnapshot::getCompanyName() const { return companyName_; }
+
+const PersistentVector<Airplane> &FleetSnapshot::getAirplanes() const { return airplanes_; }
+
+const PersistentVector<Destination> &FleetSnapshot::getDestinations() const {
+    return destinations_;
+}
+
+const vector<shared_ptr<const PlaneClass> > &FleetSnapshot::getPlaneClasses() const {
+    return planeClasses_;
+}
+
+const Airplane *FleetSnapshot::findAirplaneById(const string &id) const {
+    const uint32_t *position = airplanePositionById_.find(id);
+    return position == nullptr ? nullptr : &airplanes_[*position];
+}
+
+const Destination *FleetSnapshot::findDestinationByCode(const string &code) const {
+    const uint32_t *position = destinationPositionByCode_.find(code);
+    return position == nullptr ? nullptr : &destinations_[*position];
+}
+
+vector<const Airplane *> FleetSnapshot::findCompatibleAirplanes(double runwayLength,
+                                                                double distance) const {
+    vector<const Airplane *> compatibleAirplanes;
+    PersistentVector<Airplane>::const_iterator airplane = airplanes_.begin();
+    for (const auto &entry : compatibility_.getEntries()) {
+        if (entry.operational && entry.minRunwayLength <= runwayLength &&
+            entry.maxRange >= distance) {
+            compatibleAirplanes.push_back(&*airplane);
+        }
+        ++airplane;
+    }
+    return compatibleAirplanes;
+}
+
+vector<const Airplane *> FleetSnapshot::findAirplanesForDestination(
+    const string &destinationCode) const {
+    vector<const Airplane *> compatibleAirplanes;
+    const Destination *destination = findDestinationByCode(destinationCode);
+    if (destination == nullptr) {
+        return compatibleAirplanes;
+    }
+    // Разстоянието зависи от базата, затова се смята веднъж за база.
+    const PersistentVector<string> &baseAirportCodes = compatibility_.getBaseAirportCodes();
+    vector<double> baseDistances;
+    baseDistances.reserve(baseAirportCodes.size());
+    for (const auto &baseCode : baseAirportCodes) {
+        baseDistances.push_back(
+            destination->distanceFromAirportKm(findDestinationByCode(baseCode)));
+    }
+
+    double runwayLength = destination->getRunwayLengthMeters();
+    PersistentVector<Airplane>::const_iterator airplane = airplanes_.begin();
+    for (const auto &entry : compatibility_.getEntries()) {
+        if (entry.operational && entry.minRunwayLength <= runwayLength &&
+            entry.maxRange >= baseDistances[entry.baseAirport]) {
+            compatibleAirplanes.push_back(&*airplane);
+        }
+        ++airplane;
+    }
+    return compatibleAirplanes;
+}
+
+vector<const Airplane *> FleetSnapshot::getOperationalAirplanes() const {
+    vector<const Airplane *> operationalAirplanes;
+    PersistentVector<Airplane>::const_iterator airplane = airplanes_.begin();
+    for (const auto &entry : compatibility_.getEntries()) {
+        if (entry.operational) {
+            operationalAirplanes.push_back(&*airplane);
+        }
+        ++airplane;
+    }
+    return operationalAirplanes;
+}
+
+void FleetSnapshot::displayAllAirplanes(ostream &os) const {
+    os << "\nСАМОЛЕТИ ВЪВ ФЛОТА" << endl;
+    os << "Общ брой самолети: " << airplanes_.size() << "\n" << endl;
+
+    if (airplanes_.empty()) {
+        os << "Няма самолети във флота." << endl;
+        return;
+    }
+
+    int count = 1;
+    for (const auto &airplane : airplanes_) {
+        os << "[" << count++ << "] ";
+        os << airplane << endl;
+    }
+}
+
+void FleetSnapshot::displayAllDestinations(ostream &os) const {
+    os << "\nДЕСТИНАЦИИ" << endl;
+    os << "Общ брой дестинации: " << destinations_.size() << "\n" << endl;
+
+    if (destinations_.empty()) {
+        os << "Няма регистрирани дестинации." << endl;
+        return;
+    }
+
+    int count = 1;
+    for (const auto &destination : destinations_) {
+        os << "[" << count++ << "] ";
+        os << destination << endl;
+    }
+}
+
+void FleetSnapshot::displayAllPlaneClasses(ostream &os) const {
+    os << "\nКЛАСОВЕ САМОЛЕТИ" << endl;
+    os << "Общ брой класове: " << planeClasses_.size() << "\n" << endl;
+
+    if (planeClasses_.empty()) {
+        os << "Няма регистрирани класове самолети." << endl;
+        return;
+    }
+
+    int count = 1;
+    for (const auto &planeClass : planeClasses_) {
+        os << "[" << count++ << "] ";
+        os << *planeClass << endl;
+    }
+}
+
+bool FleetSnapshot::saveBinary(const string &filename, unsigned long generation) const {
+    SnapshotStringTable strings;
+    SnapshotHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC));
+    header.version = SNAPSHOT_VERSION;
+    header.headerSize = sizeof(SnapshotHeader);
+    header.generation = static_cast<uint32_t>(generation);
+    header.companyName = strings.add(companyName_);
+
+    unordered_map<const PlaneClass *, uint32_t> classIndexByRecord;
+    vector<SnapshotPlaneClass> classRecords(planeClasses_.size());
+    for (size_t i = 0; i < planeClasses_.size(); ++i) {
+        const PlaneClass &pc = *planeClasses_[i];
+        SnapshotPlaneClass &record = classRecords[i];
+        record.manufacturer = strings.add(pc.getManufacturer());
+        record.model = strings.add(pc.getModel());
+        record.minRunwayLength = pc.getMinRunwayLength();
+        record.fuelConsumptionPerKmPerSeat = pc.getFuelConsumptionPerKmPerSeat();
+        record.tankVolumeLiters = pc.getTankVolumeLiters();
+        record.averageSpeedKmh = pc.getAverageSpeedKmh();
+        record.maxRange = pc.calculateMaxRange();
+        record.seatCount = pc.getSeatCount();
+        record.requiredCrewCount = pc.getRequiredCrewCount();
+        classIndexByRecord.emplace(&pc, static_cast<uint32_t>(i));
+    }
+
+    vector<SnapshotAirplane> airplaneRecords(airplanes_.size());
+    size_t i = 0;
+    for (const auto &airplane : airplanes_) {
+        SnapshotAirplane &record = airplaneRecords[i++];
+        memset(&record, 0, sizeof(record));
+        record.identificationNumber = strings.add(airplane.getIdentificationNumberRef());
+        record.baseAirportCode = strings.add(airplane.getBaseAirportCodeRef());
+        record.planeClassIndex = classIndexByRecord.at(&airplane.getPlaneClassRef());
+        record.totalFlightHours = airplane.getTotalFlightHours();
+        record.operational = airplane.isOperational() ? 1 : 0;
+    }
+
+    vector<SnapshotDestination> destinationRecords(destinations_.size());
+    i = 0;
+    for (const auto &destination : destinations_) {
+        SnapshotDestination &record = destinationRecords[i++];
+        record.code = strings.add(destination.getCodeRef());
+        record.name = strings.add(destination.getName());
+        record.city = strings.add(destination.getCity());
+        record.country = strings.add(destination.getCountry());
+        record.runwayLengthMeters = destination.getRunwayLengthMeters();
+        record.distanceFromBaseKm = destination.getDistanceFromBaseKm();
+        record.latitude = destination.getLatitude();
+        record.longitude = destination.getLongitude();
+        record.hasCoordinates = destination.hasCoordinates() ? 1 : 0;
+    }
+
+    header.planeClassCount = static_cast<uint32_t>(classRecords.size());
+    header.airplaneCount = static_cast<uint32_t>(airplaneRecords.size());
+    header.destinationCount = static_cast<uint32_t>(destinationRecords.size());
+    header.planeClassOffset = sizeof(SnapshotHeader);
+    header.airplaneOffset =
+        header.planeClassOffset + classRecords.size() * sizeof(SnapshotPlaneClass);
+    header.destinationOffset =
+        header.airplaneOffset + airplaneRecords.size() * sizeof(SnapshotAirplane);
+    header.stringTableOffset =
+        header.destinationOffset + destinationRecords.size() * sizeof(SnapshotDestination);
+    header.stringTableSize = strings.getData().size();
+
+    vector<char> buffer(header.stringTableOffset + header.stringTableSize);
+    memcpy(&buffer[header.planeClassOffset], classRecords.data(),
+           classRecords.size() * sizeof(SnapshotPlaneClass));
+    memcpy(&buffer[header.airplaneOffset], airplaneRecords.data(),
+           airplaneRecords.size() * sizeof(SnapshotAirplane));
+    memcpy(&buffer[header.destinationOffset], destinationRecords.data(),
+           destinationRecords.size() * sizeof(SnapshotDestination));
+    memcpy(&buffer[header.stringTableOffset], strings.getData().data(), header.stringTableSize);
+    header.checksum = computeSnapshotChecksum(&buffer[sizeof(SnapshotHeader)],
+                                              buffer.size() - sizeof(SnapshotHeader));
+    memcpy(&buffer[0], &header, sizeof(header));
+
+    string temporaryName = filename + ".tmp";
+    if (!writeFileDurably(temporaryName, buffer.data(), buffer.size())) {
+        remove(temporaryName.c_str());
+        return false;
+    }
+    return renameDurably(temporaryName, filename);
+}
@@ -0,0 +1,80 @@
+#include "../headers/FleetTransaction.h"
+
+using namespace std;
+
+FleetTransaction::FleetTransaction()
+    : operations_(), planeClasses_(), airplanes_(), destinations_() {}
+
+void FleetTransaction::stage(OperationType type, const string &key, const string &text,
+                             bool flag, double value, size_t item) {
+    operations_.push_back(Operation{type, key, text, flag, value, item});
+}
+
+void FleetTransaction::addPlaneClass(const PlaneClass &planeClass) {
+    stage(ADD_PLANE_CLASS, planeClass.getClassId(), "", false, 0.0, planeClasses_.size());
+    planeClasses_.push_back(planeClass);
+}
+
+void FleetTransaction::updatePlaneClass(const PlaneClass &planeClass) {
+    stage(UPDATE_PLANE_CLASS, planeClass.getClassId(), "", false, 0.0, planeClasses_.size());
+    planeClasses_.push_back(planeClass);
+}
+
+void FleetTransaction::addAirplane(const Airplane &airplane) {
+    stage(ADD_AIRPLANE, airplane.getIdentificationNumber(), "", false, 0.0, airplanes_.size());
+    airplanes_.push_back(airplane);
+}
+
+void FleetTransaction::removeAirplane(const string &id) {
+    stage(REMOVE_AIRPLANE, id, "", false, 0.0, 0);
+}
+
+void FleetTransaction::setAirplaneOperational(const string &id, bool operational) {
+    stage(SET_AIRPLANE_OPERATIONAL, id, "", operational, 0.0, 0);
+}
+
+void FleetTransaction::addAirplaneFlightHours(const string &id, int hours) {
+    stage(ADD_AIRPLANE_FLIGHT_HOURS, id, "", false, hours, 0);
+}
+
+void FleetTransaction::setAirplaneBase(const string &id, const string &baseAirportCode) {
+    stage(SET_AIRPLANE_BASE, id, baseAirportCode, false, 0.0, 0);
+}
+
+void FleetTransaction::addDestination(const Destination &destination) {
+    stage(ADD_DESTINATION, destination.getCode(), "", false, 0.0, destinations_.size());
+    destinations_.push_back(destination);
+}
+
+void FleetTransaction::removeDestination(const string &code) {
+    stage(REMOVE_DESTINATION, code, "", false, 0.0, 0);
+}
+
+void FleetTransaction::setDestinationRunwayLength(const string &code, double length) {
+    stage(SET_DESTINATION_RUNWAY, code, "", false, length, 0);
+}
+
+size_t FleetTransaction::size() const { return operations_.size(); }
+
+bool FleetTransaction::empty() const { return operations_.empty(); }
+
+void FleetTransaction::clear() {
+    operations_.clear();
+    planeClasses_.clear();
+    airplanes_.clear();
+    destinations_.clear();
+}
+
+const vector<FleetTransaction::Operation> &FleetTransaction::getOperations() const {
+    return operations_;
+}
+
+const PlaneClass &FleetTransaction::getPlaneClass(size_t item) const {
+    return planeClasses_[item];
+}
+
+const Airplane &FleetTransaction::getAirplane(size_t item) const { return airplanes_[item]; }
+
+const Destination &FleetTransaction::getDestination(size_t item) const {
+    return destinations_[item];
+}
@@ -0,0 +1,130 @@
+#include "../headers/FleetViews.h"
+
+using namespace std;
+
+namespace {
+
+const uint32_t NOT_IN_VIEW = UINT32_MAX;
+
+template <typename T>
+vector<T> &listAt(vector<vector<T> > &lists, uint32_t index) {
+    if (index >= lists.size()) {
+        lists.resize(index + 1);
+    }
+    return lists[index];
+}
+
+}
+
+FleetViews::FleetViews()
+    : operational_(), operationalPositions_(), links_(), freeLinks_(), linksByDestination_(),
+      linksByAirplane_() {}
+
+size_t FleetViews::getLinkCount() const { return links_.size() - freeLinks_.size(); }
+
+void FleetViews::clear() {
+    operational_.clear();
+    operationalPositions_.clear();
+    links_.clear();
+    freeLinks_.clear();
+    linksByDestination_.clear();
+    linksByAirplane_.clear();
+}
+
+void FleetViews::setOperational(SlotHandle<Airplane> airplane, bool operational) {
+    if (airplane.index >= operationalPositions_.size()) {
+        operationalPositions_.resize(airplane.index + 1, NOT_IN_VIEW);
+    }
+    uint32_t &position = operationalPositions_[airplane.index];
+    if (operational && position == NOT_IN_VIEW) {
+        position = static_cast<uint32_t>(operational_.size());
+        operational_.push_back(airplane);
+    } else if (!operational && position != NOT_IN_VIEW) {
+        SlotHandle<Airplane> last = operational_.back();
+        operational_[position] = last;
+        operationalPositions_[last.index] = position;
+        operational_.pop_back();
+        position = NOT_IN_VIEW;
+    }
+}
+
+void FleetViews::link(SlotHandle<Destination> destination, SlotHandle<Airplane> airplane) {
+    uint32_t link;
+    if (!freeLinks_.empty()) {
+        link = freeLinks_.back();
+        freeLinks_.pop_back();
+    } else {
+        link = static_cast<uint32_t>(links_.size());
+        links_.push_back(Link());
+    }
+    vector<uint32_t> &destinationLinks = listAt(linksByDestination_, destination.index);
+    vector<uint32_t> &airplaneLinks = listAt(linksByAirplane_, airplane.index);
+    links_[link] = Link{destination, airplane, static_cast<uint32_t>(destinationLinks.size()),
+                        static_cast<uint32_t>(airplaneLinks.size())};
+    destinationLinks.push_back(link);
+    airplaneLinks.push_back(link);
+}
+
+void FleetViews::detachFromDestination(uint32_t link) {
+    vector<uint32_t> &links = linksByDestination_[links_[link].destination.index];
+    uint32_t position = links_[link].destinationPosition;
+    links[position] = links.back();
+    links_[links[position]].destinationPosition = position;
+    links.pop_back();
+}
+
+void FleetViews::detachFromAirplane(uint32_t link) {
+    vector<uint32_t> &links = linksByAirplane_[links_[link].airplane.index];
+    uint32_t position = links_[link].airplanePosition;
+    links[position] = links.back();
+    links_[links[position]].airplanePosition = position;
+    links.pop_back();
+}
+
+void FleetViews::unlinkAirplane(SlotHandle<Airplane> airplane) {
+    if (airplane.index >= linksByAirplane_.size()) {
+        return;
+    }
+    vector<uint32_t> &links = linksByAirplane_[airplane.index];
+    for (uint32_t link : links) {
+        detachFromDestination(link);
+        freeLinks_.push_back(link);
+    }
+    links.clear();
+}
+
+void FleetViews::unlinkDestination(SlotHandle<Destination> destination) {
+    if (destination.index >= linksByDestination_.size()) {
+        return;
+    }
+    vector<uint32_t> &links = linksByDestination_[destination.index];
+    for (uint32_t link : links) {
+        detachFromAirplane(link);
+        freeLinks_.push_back(link);
+    }
+    links.clear();
+}
+
+const vector<SlotHandle<Airplane> > &FleetViews::getOperationalAirplanes() const {
+    return operational_;
+}
+
+vector<SlotHandle<Airplane> > FleetViews::getAirplanesForDestination(
+    SlotHandle<Destination> destination) const {
+    vector<SlotHandle<Airplane> > airplanes;
+    if (destination.index >= linksByDestination_.size()) {
+        return airplanes;
+    }
+    const vector<uint32_t> &links = linksByDestination_[destination.index];
+    airplanes.reserve(links.size());
+    for (uint32_t link : links) {
+        airplanes.push_back(links_[link].airplane);
+    }
+    return airplanes;
+}
+
+size_t FleetViews::countAirplanesForDestination(SlotHandle<Destination> destination) const {
+    return destination.index < linksByDestination_.size()
+               ? linksByDestination_[destination.index].size()
+               : 0;
+}
@@ -0,0 +1,112 @@
+#include "../headers/GeoIndex.h"
+#include <algorithm>
+#include <cmath>
+
+using namespace std;
+
+namespace {
+
+// Допуск за закръглянето: около милиметър по повърхността.
+const double CHORD_TOLERANCE = 1e-10;
+
+void unitVector(const Destination &destination, double *coordinates) {
+    const double radiansPerDegree = acos(-1.0) / 180.0;
+    double latitude = destination.getLatitude() * radiansPerDegree;
+    double longitude = destination.getLongitude() * radiansPerDegree;
+    coordinates[0] = cos(latitude) * cos(longitude);
+    coordinates[1] = cos(latitude) * sin(longitude);
+    coordinates[2] = sin(latitude);
+}
+
+}
+
+GeoIndex::GeoIndex() : points_() {}
+
+GeoIndex::GeoIndex(const vector<Destination> &destinations) : points_() {
+    for (size_t i = 0; i < destinations.size(); ++i) {
+        if (!destinations[i].hasCoordinates()) {
+            continue;
+        }
+        Point point;
+        unitVector(destinations[i], point.coordinates);
+        point.position = static_cast<uint32_t>(i);
+        point.splitAxis = 0;
+        points_.push_back(point);
+    }
+    build(0, points_.size());
+}
+
+size_t GeoIndex::size() const { return points_.size(); }
+
+void GeoIndex::build(size_t first, size_t last) {
+    if (last - first <= 1) {
+        return;
+    }
+    // Разделя се по оста с най-голям разброс, а не циклично: летищата са
+    // на сфера и по една от осите често почти не се различават.
+    double low[3] = {2.0, 2.0, 2.0};
+    double high[3] = {-2.0, -2.0, -2.0};
+    for (size_t i = first; i < last; ++i) {
+        for (int axis = 0; axis < 3; ++axis) {
+            low[axis] = min(low[axis], points_[i].coordinates[axis]);
+            high[axis] = max(high[axis], points_[i].coordinates[axis]);
+        }
+    }
+    uint8_t splitAxis = 0;
+    for (uint8_t axis = 1; axis < 3; ++axis) {
+        if (high[axis] - low[axis] > high[splitAxis] - low[splitAxis]) {
+            splitAxis = axis;
+        }
+    }
+
+    size_t middle = first + (last - first) / 2;
+    nth_element(points_.begin() + first, points_.begin() + middle, points_.begin() + last,
+                [splitAxis](const Point &left, const Point &right) {
+                    return left.coordinates[splitAxis] < right.coordinates[splitAxis];
+                });
+    points_[middle].splitAxis = splitAxis;
+    build(first, middle);
+    build(middle + 1, last);
+}
+
+void GeoIndex::collect(size_t first, size_t last, const double *center, double maxChordSquared,
+                       vector<uint32_t> &positions) const {
+    while (first < last) {
+        size_t middle = first + (last - first) / 2;
+        const Point &point = points_[middle];
+        double chordSquared = 0.0;
+        for (int axis = 0; axis < 3; ++axis) {
+            double delta = point.coordinates[axis] - center[axis];
+            chordSquared += delta * delta;
+        }
+        if (chordSquared <= maxChordSquared) {
+            positions.push_back(point.position);
+        }
+
+        double offset = center[point.splitAxis] - point.coordinates[point.splitAxis];
+        bool farSideReachable = offset * offset <= maxChordSquared;
+        if (offset < 0.0) {
+            if (farSideReachable) {
+                collect(middle + 1, last, center, maxChordSquared, positions);
+            }
+            last = middle;
+        } else {
+            if (farSideReachable) {
+                collect(first, middle, center, maxChordSquared, positions);
+            }
+            first = middle + 1;
+        }
+    }
+}
+
+void GeoIndex::findWithinKm(const Destination &center, double radiusKm,
+                            vector<uint32_t> &positions) const {
+    if (radiusKm < 0.0) {
+        return;
+    }
+    double angle = min(radiusKm / EARTH_RADIUS_KM, acos(-1.0));
+    double chord = 2.0 * sin(angle / 2.0) + CHORD_TOLERANCE;
+    double centerCoordinates[3];
+    unitVector(center, centerCoordinates);
+    collect(0, points_.size(), centerCoordinates, chord * chord, positions);
+}
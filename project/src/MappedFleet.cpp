@@ -0,0 +1,199 @@
+#include "../headers/MappedFleet.h"
+#include "../headers/Destination.h"
+#include <algorithm>
+#include <unordered_map>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace std;
+
+MappedFleet::MappedFleet()
+    : data_(nullptr), size_(0), header_(nullptr), planeClasses_(nullptr),
+      airplanes_(nullptr), destinations_(nullptr), airplaneOrderById_(),
+      destinationOrderByCode_() {}
+
+MappedFleet::~MappedFleet() { close(); }
+
+bool MappedFleet::open(const string &dataDirectory) {
+    return openFile(dataDirectory + "/" + SNAPSHOT_FILE_NAME);
+}
+
+bool MappedFleet::openFile(const string &filename) {
+    close();
+
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size < static_cast<off_t>(sizeof(SnapshotHeader))) {
+        ::close(fd);
+        return false;
+    }
+    void *mapping = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (mapping == MAP_FAILED) {
+        return false;
+    }
+
+    data_ = static_cast<const char *>(mapping);
+    size_ = static_cast<size_t>(info.st_size);
+    if (!validateSnapshot(data_, size_)) {
+        close();
+        return false;
+    }
+
+    header_ = reinterpret_cast<const SnapshotHeader *>(data_);
+    planeClasses_ = reinterpret_cast<const SnapshotPlaneClass *>(data_ + header_->planeClassOffset);
+    airplanes_ = reinterpret_cast<const SnapshotAirplane *>(data_ + header_->airplaneOffset);
+    destinations_ =
+        reinterpret_cast<const SnapshotDestination *>(data_ + header_->destinationOffset);
+    buildLookupOrders();
+    return true;
+}
+
+void MappedFleet::close() {
+    if (data_ != nullptr) {
+        munmap(const_cast<char *>(data_), size_);
+    }
+    data_ = nullptr;
+    size_ = 0;
+    header_ = nullptr;
+    planeClasses_ = nullptr;
+    airplanes_ = nullptr;
+    destinations_ = nullptr;
+    airplaneOrderById_.clear();
+    destinationOrderByCode_.clear();
+}
+
+bool MappedFleet::isOpen() const { return data_ != nullptr; }
+
+void MappedFleet::buildLookupOrders() {
+    airplaneOrderById_.resize(header_->airplaneCount);
+    for (uint32_t i = 0; i < header_->airplaneCount; ++i) {
+        airplaneOrderById_[i] = i;
+    }
+    sort(airplaneOrderById_.begin(), airplaneOrderById_.end(), [this](uint32_t a, uint32_t b) {
+        return getString(airplanes_[a].identificationNumber) <
+               getString(airplanes_[b].identificationNumber);
+    });
+
+    destinationOrderByCode_.resize(header_->destinationCount);
+    for (uint32_t i = 0; i < header_->destinationCount; ++i) {
+        destinationOrderByCode_[i] = i;
+    }
+    sort(destinationOrderByCode_.begin(), destinationOrderByCode_.end(),
+         [this](uint32_t a, uint32_t b) {
+             return getString(destinations_[a].code) < getString(destinations_[b].code);
+         });
+}
+
+string_view MappedFleet::getCompanyName() const { return getString(header_->companyName); }
+
+size_t MappedFleet::getPlaneClassCount() const {
+    return header_ == nullptr ? 0 : header_->planeClassCount;
+}
+
+size_t MappedFleet::getAirplaneCount() const {
+    return header_ == nullptr ? 0 : header_->airplaneCount;
+}
+
+size_t MappedFleet::getDestinationCount() const {
+    return header_ == nullptr ? 0 : header_->destinationCount;
+}
+
+const SnapshotPlaneClass &MappedFleet::getPlaneClass(size_t index) const {
+    return planeClasses_[index];
+}
+
+const SnapshotAirplane &MappedFleet::getAirplane(size_t index) const { return airplanes_[index]; }
+
+const SnapshotDestination &MappedFleet::getDestination(size_t index) const {
+    return destinations_[index];
+}
+
+string_view MappedFleet::getString(const SnapshotString &value) const {
+    return string_view(data_ + header_->stringTableOffset + value.offset, value.length);
+}
+
+const SnapshotAirplane *MappedFleet::findAirplaneById(string_view id) const {
+    auto found = lower_bound(airplaneOrderById_.begin(), airplaneOrderById_.end(), id,
+                             [this](uint32_t index, string_view key) {
+                                 return getString(airplanes_[index].identificationNumber) < key;
+                             });
+    if (found == airplaneOrderById_.end() ||
+        getString(airplanes_[*found].identificationNumber) != id) {
+        return nullptr;
+    }
+    return &airplanes_[*found];
+}
+
+const SnapshotDestination *MappedFleet::findDestinationByCode(string_view code) const {
+    auto found = lower_bound(destinationOrderByCode_.begin(), destinationOrderByCode_.end(), code,
+                             [this](uint32_t index, string_view key) {
+                                 return getString(destinations_[index].code) < key;
+                             });
+    if (found == destinationOrderByCode_.end() || getString(destinations_[*found].code) != code) {
+        return nullptr;
+    }
+    return &destinations_[*found];
+}
+
+void MappedFleet::findCompatibleAirplanes(double runwayLength, double distance,
+                                          vector<uint32_t> &airplaneIndices) const {
+    size_t classCount = getPlaneClassCount();
+    vector<uint8_t> compatibleClass(classCount);
+    for (size_t i = 0; i < classCount; ++i) {
+        compatibleClass[i] = runwayLength >= planeClasses_[i].minRunwayLength &&
+                             distance <= planeClasses_[i].maxRange;
+    }
+
+    size_t airplaneCount = getAirplaneCount();
+    for (size_t i = 0; i < airplaneCount; ++i) {
+        const SnapshotAirplane &airplane = airplanes_[i];
+        if (airplane.operational != 0 && compatibleClass[airplane.planeClassIndex] != 0) {
+            airplaneIndices.push_back(static_cast<uint32_t>(i));
+        }
+    }
+}
+
+void MappedFleet::findAirplanesForDestination(string_view destinationCode,
+                                              vector<uint32_t> &airplaneIndices) const {
+    const SnapshotDestination *destination = findDestinationByCode(destinationCode);
+    if (destination == nullptr) {
+        return;
+    }
+    size_t classCount = getPlaneClassCount();
+    vector<uint8_t> compatibleRunway(classCount);
+    for (size_t i = 0; i < classCount; ++i) {
+        compatibleRunway[i] = destination->runwayLengthMeters >= planeClasses_[i].minRunwayLength;
+    }
+
+    // Както в Destination::distanceFromAirportKm: без координати се ползва
+    // записаното разстояние от базата.
+    unordered_map<string_view, double> distanceByBase;
+    size_t airplaneCount = getAirplaneCount();
+    for (size_t i = 0; i < airplaneCount; ++i) {
+        const SnapshotAirplane &airplane = airplanes_[i];
+        if (airplane.operational == 0 || compatibleRunway[airplane.planeClassIndex] == 0) {
+            continue;
+        }
+        string_view baseCode = getString(airplane.baseAirportCode);
+        auto base = distanceByBase.find(baseCode);
+        if (base == distanceByBase.end()) {
+            double distance = destination->distanceFromBaseKm;
+            const SnapshotDestination *airport = findDestinationByCode(baseCode);
+            if (airport != nullptr && airport->hasCoordinates != 0 &&
+                destination->hasCoordinates != 0) {
+                distance = greatCircleDistanceKm(airport->latitude, airport->longitude,
+                                                 destination->latitude, destination->longitude);
+            }
+            base = distanceByBase.emplace(baseCode, distance).first;
+        }
+        if (base->second <= planeClasses_[airplane.planeClassIndex].maxRange) {
+            airplaneIndices.push_back(static_cast<uint32_t>(i));
+        }
+    }
+}
@@ -0,0 +1,122 @@
+#include "../headers/MinCostFlow.h"
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <queue>
+
+using namespace std;
+
+MinCostFlow::MinCostFlow(size_t nodeCount)
+    : adjacency_(nodeCount), residualCounts_(nodeCount, 0), slotPositions_(),
+      potential_(nodeCount, 0) {}
+
+size_t MinCostFlow::getNodeCount() const { return adjacency_.size(); }
+
+MinCostFlow::Edge &MinCostFlow::edgeAt(uint32_t slot) {
+    const pair<uint32_t, uint32_t> &position = slotPositions_[slot];
+    return adjacency_[position.first][position.second];
+}
+
+void MinCostFlow::moveEdge(uint32_t node, uint32_t from, uint32_t to) {
+    vector<Edge> &edges = adjacency_[node];
+    swap(edges[from], edges[to]);
+    slotPositions_[edges[from].slot].second = from;
+    slotPositions_[edges[to].slot].second = to;
+}
+
+void MinCostFlow::changeCapacity(uint32_t slot, int32_t delta) {
+    pair<uint32_t, uint32_t> position = slotPositions_[slot];
+    Edge &edge = adjacency_[position.first][position.second];
+    bool wasResidual = edge.capacity > 0;
+    edge.capacity += delta;
+    bool isResidual = edge.capacity > 0;
+    if (!wasResidual && isResidual) {
+        moveEdge(position.first, position.second, residualCounts_[position.first]++);
+    } else if (wasResidual && !isResidual) {
+        moveEdge(position.first, position.second, --residualCounts_[position.first]);
+    }
+}
+
+size_t MinCostFlow::addEdge(size_t from, size_t to, int32_t capacity, int64_t cost) {
+    uint32_t slot = static_cast<uint32_t>(slotPositions_.size());
+    slotPositions_.push_back(make_pair(static_cast<uint32_t>(from),
+                                       static_cast<uint32_t>(adjacency_[from].size())));
+    adjacency_[from].push_back(Edge{static_cast<uint32_t>(to), slot, 0, cost});
+    slotPositions_.push_back(make_pair(static_cast<uint32_t>(to),
+                                       static_cast<uint32_t>(adjacency_[to].size())));
+    adjacency_[to].push_back(Edge{static_cast<uint32_t>(from), slot + 1, 0, -cost});
+    changeCapacity(slot, capacity);
+    return slot / 2;
+}
+
+int32_t MinCostFlow::getFlow(size_t edge) const {
+    const pair<uint32_t, uint32_t> &position = slotPositions_[2 * edge + 1];
+    return adjacency_[position.first][position.second].capacity;
+}
+
+bool MinCostFlow::augment(size_t from, size_t sink, int64_t &pathCost) {
+    const int64_t infinity = numeric_limits<int64_t>::max();
+    size_t nodeCount = adjacency_.size();
+
+    // Потенциалът на нов източник се вдига така, че намалените цени на
+    // излизащите от него ребра да не са отрицателни.
+    const vector<Edge> &sourceEdges = adjacency_[from];
+    if (residualCounts_[from] == 0) {
+        return false;
+    }
+    int64_t sourcePotential = potential_[sourceEdges[0].to] - sourceEdges[0].cost;
+    for (uint32_t i = 1; i < residualCounts_[from]; ++i) {
+        const Edge &edge = sourceEdges[i];
+        sourcePotential = max(sourcePotential, potential_[edge.to] - edge.cost);
+    }
+    potential_[from] = sourcePotential;
+
+    vector<int64_t> distance(nodeCount, infinity);
+    vector<uint32_t> parentNode(nodeCount);
+    vector<uint32_t> parentSlot(nodeCount);
+    typedef pair<int64_t, uint32_t> QueueEntry;
+    priority_queue<QueueEntry, vector<QueueEntry>, greater<QueueEntry> > queue;
+    distance[from] = 0;
+    queue.push(QueueEntry(0, static_cast<uint32_t>(from)));
+    while (!queue.empty()) {
+        QueueEntry top = queue.top();
+        queue.pop();
+        uint32_t node = top.second;
+        if (top.first > distance[node]) {
+            continue;
+        }
+        // Щом целта е достигната, по-далечните върхове не влияят на пътя.
+        if (node == sink) {
+            break;
+        }
+        const vector<Edge> &edges = adjacency_[node];
+        for (uint32_t i = 0; i < residualCounts_[node]; ++i) {
+            const Edge &edge = edges[i];
+            int64_t candidate = top.first + edge.cost + potential_[node] - potential_[edge.to];
+            if (candidate < distance[edge.to]) {
+                distance[edge.to] = candidate;
+                parentNode[edge.to] = node;
+                parentSlot[edge.to] = edge.slot;
+                queue.push(QueueEntry(candidate, edge.to));
+            }
+        }
+    }
+    if (distance[sink] == infinity) {
+        return false;
+    }
+
+    // Върховете след целта получават нейното разстояние; така намалените
+    // цени остават неотрицателни, без да се обхожда целият граф.
+    for (size_t node = 0; node < nodeCount; ++node) {
+        potential_[node] += min(distance[node], distance[sink]);
+    }
+
+    pathCost = 0;
+    for (size_t node = sink; node != from; node = parentNode[node]) {
+        uint32_t slot = parentSlot[node];
+        pathCost += edgeAt(slot).cost;
+        changeCapacity(slot, -1);
+        changeCapacity(slot ^ 1, 1);
+    }
+    return true;
+}
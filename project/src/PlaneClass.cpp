@@ -5,7 +5,7 @@
 using namespace std;
 
 PlaneClass::PlaneClass()
-    : manufacturer_(""), model_(""), seatCount_(0), minRunwayLength_(0.0),
+    : manufacturer_(""), model_(""), classId_(" "), seatCount_(0), minRunwayLength_(0.0),
       fuelConsumptionPerKmPerSeat_(0.0), tankVolumeLiters_(0.0),
       averageSpeedKmh_(0.0), requiredCrewCount_(0) {}
 
@@ -13,7 +13,8 @@ PlaneClass::PlaneClass(const string &manufacturer, const string &model,
                        int seatCount, double minRunwayLength,
                        double fuelConsumption, double tankVolume,
                        double avgSpeed, int crewCount)
-    : manufacturer_(manufacturer), model_(model), seatCount_(0),
+    : manufacturer_(manufacturer), model_(model), classId_(manufacturer + " " + model),
+      seatCount_(0),
       minRunwayLength_(0.0), fuelConsumptionPerKmPerSeat_(0.0),
       tankVolumeLiters_(0.0), averageSpeedKmh_(0.0), requiredCrewCount_(0) {
 
@@ -26,15 +27,56 @@ PlaneClass::PlaneClass(const string &manufacturer, const string &model,
 }
 
 PlaneClass::PlaneClass(const PlaneClass &other)
-    : manufacturer_(other.manufacturer_), model_(other.model_),
+    : manufacturer_(other.manufacturer_), model_(other.model_), classId_(other.classId_),
       seatCount_(other.seatCount_), minRunwayLength_(other.minRunwayLength_),
       fuelConsumptionPerKmPerSeat_(other.fuelConsumptionPerKmPerSeat_),
       tankVolumeLiters_(other.tankVolumeLiters_),
       averageSpeedKmh_(other.averageSpeedKmh_),
       requiredCrewCount_(other.requiredCrewCount_) {}
 
+PlaneClass::PlaneClass(PlaneClass &&other) noexcept
+    : manufacturer_(move(other.manufacturer_)), model_(move(other.model_)),
+      classId_(move(other.classId_)), seatCount_(other.seatCount_),
+      minRunwayLength_(other.minRunwayLength_),
+      fuelConsumptionPerKmPerSeat_(other.fuelConsumptionPerKmPerSeat_),
+      tankVolumeLiters_(other.tankVolumeLiters_),
+      averageSpeedKmh_(other.averageSpeedKmh_),
+      requiredCrewCount_(other.requiredCrewCount_) {}
+
 PlaneClass::~PlaneClass() {}
 
+PlaneClass &PlaneClass::operator=(const PlaneClass &other) {
+    if (this == &other) {
+        return *this;
+    }
+    manufacturer_ = other.manufacturer_;
+    model_ = other.model_;
+    classId_ = other.classId_;
+    seatCount_ = other.seatCount_;
+    minRunwayLength_ = other.minRunwayLength_;
+    fuelConsumptionPerKmPerSeat_ = other.fuelConsumptionPerKmPerSeat_;
+    tankVolumeLiters_ = other.tankVolumeLiters_;
+    averageSpeedKmh_ = other.averageSpeedKmh_;
+    requiredCrewCount_ = other.requiredCrewCount_;
+    return *this;
+}
+
+PlaneClass &PlaneClass::operator=(PlaneClass &&other) noexcept {
+    if (this == &other) {
+        return *this;
+    }
+    manufacturer_ = move(other.manufacturer_);
+    model_ = move(other.model_);
+    classId_ = move(other.classId_);
+    seatCount_ = other.seatCount_;
+    minRunwayLength_ = other.minRunwayLength_;
+    fuelConsumptionPerKmPerSeat_ = other.fuelConsumptionPerKmPerSeat_;
+    tankVolumeLiters_ = other.tankVolumeLiters_;
+    averageSpeedKmh_ = other.averageSpeedKmh_;
+    requiredCrewCount_ = other.requiredCrewCount_;
+    return *this;
+}
+
 string PlaneClass::getManufacturer() const { return manufacturer_; }
 
 string PlaneClass::getModel() const { return model_; }
@@ -58,6 +100,7 @@ void PlaneClass::setManufacturer(const string &manufacturer) {
         throw invalid_argument("Името на производителя не може да е празно");
     }
     manufacturer_ = manufacturer;
+    classId_ = manufacturer_ + " " + model_;
 }
 
 void PlaneClass::setModel(const string &model) {
@@ -65,6 +108,7 @@ void PlaneClass::setModel(const string &model) {
         throw invalid_argument("Името на модела не може да е празно");
     }
     model_ = model;
+    classId_ = manufacturer_ + " " + model_;
 }
 
 void PlaneClass::setSeatCount(int count) {
@@ -109,7 +153,9 @@ void PlaneClass::setRequiredCrewCount(int count) {
     requiredCrewCount_ = count;
 }
 
-string PlaneClass::getClassId() const { return manufacturer_ + " " + model_; }
+string PlaneClass::getClassId() const { return classId_; }
+
+const string &PlaneClass::getClassIdRef() const { return classId_; }
 
 double PlaneClass::calculateMaxRange() const {
     if (fuelConsumptionPerKmPerSeat_ <= 0.0 || seatCount_ <= 0) {
@@ -167,6 +213,7 @@ istream &operator>>(istream &is, PlaneClass &planeClass) {
         planeClass.fuelConsumptionPerKmPerSeat_ >>
         planeClass.tankVolumeLiters_ >> planeClass.averageSpeedKmh_ >>
         planeClass.requiredCrewCount_;
+    planeClass.classId_ = planeClass.manufacturer_ + " " + planeClass.model_;
     return is;
 }
 
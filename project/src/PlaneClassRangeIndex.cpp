@@ -0,0 +1,79 @@
+#include "../headers/PlaneClassRangeIndex.h"
+#include <algorithm>
+
+using namespace std;
+
+PlaneClassRangeIndex::PlaneClassRangeIndex()
+    : sortedMinRunwayLengths_(), leafCount_(0), nodes_() {}
+
+void PlaneClassRangeIndex::rebuild(const vector<shared_ptr<const PlaneClass> > &planeClasses) {
+    clear();
+
+    vector<uint32_t> order(planeClasses.size());
+    for (size_t i = 0; i < order.size(); ++i) {
+        order[i] = static_cast<uint32_t>(i);
+    }
+    sort(order.begin(), order.end(), [&planeClasses](uint32_t a, uint32_t b) {
+        return planeClasses[a]->getMinRunwayLength() < planeClasses[b]->getMinRunwayLength();
+    });
+
+    leafCount_ = 1;
+    while (leafCount_ < order.size()) {
+        leafCount_ *= 2;
+    }
+    nodes_.assign(2 * leafCount_, vector<Entry>());
+    sortedMinRunwayLengths_.reserve(order.size());
+
+    for (size_t i = 0; i < order.size(); ++i) {
+        const PlaneClass &planeClass = *planeClasses[order[i]];
+        sortedMinRunwayLengths_.push_back(planeClass.getMinRunwayLength());
+        nodes_[leafCount_ + i].push_back(Entry{planeClass.calculateMaxRange(), order[i]});
+    }
+
+    auto byRangeDescending = [](const Entry &a, const Entry &b) {
+        return a.maxRange > b.maxRange;
+    };
+    for (size_t node = leafCount_ - 1; node >= 1; --node) {
+        const vector<Entry> &left = nodes_[2 * node];
+        const vector<Entry> &right = nodes_[2 * node + 1];
+        nodes_[node].resize(left.size() + right.size());
+        merge(left.begin(), left.end(), right.begin(), right.end(),
+              nodes_[node].begin(), byRangeDescending);
+    }
+}
+
+void PlaneClassRangeIndex::clear() {
+    sortedMinRunwayLengths_.clear();
+    leafCount_ = 0;
+    nodes_.clear();
+}
+
+void PlaneClassRangeIndex::collectNode(const vector<Entry> &node, double distance,
+                                       vector<uint32_t> &positions) {
+    for (const auto &entry : node) {
+        if (entry.maxRange < distance) {
+            break;
+        }
+        positions.push_back(entry.position);
+    }
+}
+
+void PlaneClassRangeIndex::findCompatible(double runwayLength, double distance,
+                                          vector<uint32_t> &positions) const {
+    size_t prefix = upper_bound(sortedMinRunwayLengths_.begin(),
+                                sortedMinRunwayLengths_.end(), runwayLength) -
+                    sortedMinRunwayLengths_.begin();
+
+    size_t left = leafCount_;
+    size_t right = leafCount_ + prefix;
+    while (left < right) {
+        if (left & 1) {
+            collectNode(nodes_[left++], distance, positions);
+        }
+        if (right & 1) {
+            collectNode(nodes_[--right], distance, positions);
+        }
+        left /= 2;
+        right /= 2;
+    }
+}
@@ -0,0 +1,194 @@
+#include "../headers/QueryServer.h"
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <fcntl.h>
+#include <poll.h>
+#include <sstream>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+using namespace std;
+
+namespace {
+
+volatile sig_atomic_t shutdownRequested = 0;
+
+bool setNonBlocking(int fd) {
+    int flags = fcntl(fd, F_GETFL, 0);
+    return flags != -1 && fcntl(fd, F_SETFL, flags | O_NONBLOCK) != -1;
+}
+
+}
+
+QueryServer::QueryServer(FleetManager &manager, const string &socketPath)
+    : interpreter_(manager), socketPath_(socketPath), listenFd_(-1), connections_() {
+    interpreter_.setReadOnly(true);
+}
+
+QueryServer::~QueryServer() { stop(); }
+
+bool QueryServer::start() {
+    sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    if (socketPath_.size() >= sizeof(address.sun_path)) {
+        return false;
+    }
+    address.sun_family = AF_UNIX;
+    memcpy(address.sun_path, socketPath_.c_str(), socketPath_.size() + 1);
+
+    listenFd_ = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listenFd_ == -1) {
+        return false;
+    }
+    unlink(socketPath_.c_str());
+    if (bind(listenFd_, reinterpret_cast<sockaddr *>(&address), sizeof(address)) == -1 ||
+        listen(listenFd_, SOMAXCONN) == -1 || !setNonBlocking(listenFd_)) {
+        stop();
+        return false;
+    }
+
+    // Клиент, който затвори връзката по време на запис, не трябва да спира
+    // сървъра, затова грешката се обработва като EPIPE вместо чрез сигнал.
+    signal(SIGPIPE, SIG_IGN);
+    shutdownRequested = 0;
+    return true;
+}
+
+void QueryServer::run() {
+    vector<pollfd> pollFds;
+    while (listenFd_ != -1 && !shutdownRequested) {
+        pollFds.clear();
+        pollFds.push_back(pollfd{listenFd_, POLLIN, 0});
+        for (const auto &connection : connections_) {
+            short events = 0;
+            if (!connection.closing && connection.output.size() < MAX_PENDING_OUTPUT_BYTES) {
+                events |= POLLIN;
+            }
+            if (connection.outputOffset < connection.output.size()) {
+                events |= POLLOUT;
+            }
+            pollFds.push_back(pollfd{connection.fd, events, 0});
+        }
+
+        if (poll(pollFds.data(), static_cast<nfds_t>(pollFds.size()), -1) == -1) {
+            if (errno == EINTR) {
+                continue;
+            }
+            break;
+        }
+
+        for (size_t i = connections_.size(); i > 0; --i) {
+            Connection &connection = connections_[i - 1];
+            short revents = pollFds[i].revents;
+            bool open = true;
+            if (revents & (POLLERR | POLLNVAL)) {
+                open = false;
+            }
+            if (open && (revents & (POLLIN | POLLHUP))) {
+                open = readRequests(connection);
+            }
+            if (open && (revents & POLLOUT)) {
+                open = writeResponses(connection);
+            }
+            bool drained = connection.outputOffset == connection.output.size();
+            if (!open || (connection.closing && drained)) {
+                closeConnection(i - 1);
+            }
+        }
+        if (pollFds[0].revents & POLLIN) {
+            acceptConnections();
+        }
+    }
+}
+
+void QueryServer::stop() {
+    while (!connections_.empty()) {
+        closeConnection(connections_.size() - 1);
+    }
+    if (listenFd_ != -1) {
+        close(listenFd_);
+        listenFd_ = -1;
+        unlink(socketPath_.c_str());
+    }
+}
+
+void QueryServer::requestShutdown() { shutdownRequested = 1; }
+
+void QueryServer::acceptConnections() {
+    while (true) {
+        int fd = accept(listenFd_, nullptr, nullptr);
+        if (fd == -1) {
+            return;
+        }
+        if (!setNonBlocking(fd)) {
+            close(fd);
+            continue;
+        }
+        connections_.push_back(Connection{fd, string(), string(), 0, false});
+    }
+}
+
+bool QueryServer::readRequests(Connection &connection) {
+    char buffer[16 * 1024];
+    ssize_t received = read(connection.fd, buffer, sizeof(buffer));
+    if (received == 0) {
+        connection.closing = true;
+        return connection.outputOffset < connection.output.size();
+    }
+    if (received < 0) {
+        return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+    }
+    connection.input.append(buffer, static_cast<size_t>(received));
+
+    ostringstream responses;
+    size_t start = 0;
+    size_t newline;
+    while (!connection.closing &&
+           (newline = connection.input.find('\n', start)) != string::npos) {
+        string_view line(connection.input.data() + start, newline - start);
+        start = newline + 1;
+        if (!line.empty() && line.back() == '\r') {
+            line.remove_suffix(1);
+        }
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+        if (!interpreter_.execute(line, responses)) {
+            connection.closing = true;
+        }
+    }
+    connection.input.erase(0, start);
+    if (connection.input.size() > MAX_REQUEST_BYTES) {
+        responses << "error\trequest_too_large\tзаявката е твърде дълга\n";
+        connection.closing = true;
+    }
+
+    if (connection.outputOffset == connection.output.size()) {
+        connection.output.clear();
+        connection.outputOffset = 0;
+    }
+    connection.output += responses.str();
+    return writeResponses(connection);
+}
+
+bool QueryServer::writeResponses(Connection &connection) {
+    while (connection.outputOffset < connection.output.size()) {
+        ssize_t sent = write(connection.fd, connection.output.data() + connection.outputOffset,
+                             connection.output.size() - connection.outputOffset);
+        if (sent < 0) {
+            return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+        }
+        connection.outputOffset += static_cast<size_t>(sent);
+    }
+    connection.output.clear();
+    connection.outputOffset = 0;
+    return true;
+}
+
+void QueryServer::closeConnection(size_t position) {
+    close(connections_[position].fd);
+    connections_[position] = move(connections_.back());
+    connections_.pop_back();
+}
@@ -0,0 +1,98 @@
+#include "../headers/RecordReader.h"
+#include <charconv>
+#include <cstdlib>
+#include <cstring>
+
+using namespace std;
+
+RecordReader::RecordReader(string_view contents, size_t begin, size_t end,
+                           size_t firstLineNumber)
+    : contents_(contents), position_(begin), end_(end), lineNumber_(firstLineNumber - 1) {}
+
+bool RecordReader::nextLine(string_view &line) {
+    while (position_ < end_) {
+        size_t newline = contents_.find('\n', position_);
+        if (newline == string_view::npos || newline > end_) {
+            newline = end_;
+        }
+        line = contents_.substr(position_, newline - position_);
+        position_ = newline + 1;
+        ++lineNumber_;
+
+        if (!line.empty() && line.back() == '\r') {
+            line.remove_suffix(1);
+        }
+        if (!line.empty()) {
+            return true;
+        }
+    }
+    return false;
+}
+
+size_t RecordReader::getLineNumber() const { return lineNumber_; }
+
+size_t RecordReader::splitFields(string_view line, char delimiter, string_view *fields,
+                                 size_t maxFields) {
+    size_t count = 0;
+    size_t start = 0;
+    while (true) {
+        size_t separator = line.find(delimiter, start);
+        if (count == maxFields) {
+            return maxFields + 1;
+        }
+        if (separator == string_view::npos) {
+            fields[count++] = line.substr(start);
+            return count;
+        }
+        fields[count++] = line.substr(start, separator - start);
+        start = separator + 1;
+    }
+}
+
+size_t RecordReader::splitWhitespace(string_view line, string_view *fields, size_t maxFields) {
+    size_t count = 0;
+    size_t position = 0;
+    while (true) {
+        while (position < line.size() && (line[position] == ' ' || line[position] == '\t')) {
+            ++position;
+        }
+        if (position == line.size()) {
+            return count;
+        }
+        if (count == maxFields) {
+            return maxFields + 1;
+        }
+        size_t start = position;
+        while (position < line.size() && line[position] != ' ' && line[position] != '\t') {
+            ++position;
+        }
+        fields[count++] = line.substr(start, position - start);
+    }
+}
+
+bool RecordReader::parseInt(string_view text, int &value) {
+    const char *last = text.data() + text.size();
+    from_chars_result result = from_chars(text.data(), last, value);
+    return result.ec == errc() && result.ptr == last && !text.empty();
+}
+
+bool RecordReader::parseDouble(string_view text, double &value) {
+    if (text.empty()) {
+        return false;
+    }
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+    const char *last = text.data() + text.size();
+    from_chars_result result = from_chars(text.data(), last, value);
+    return result.ec == errc() && result.ptr == last;
+#else
+    char buffer[64];
+    if (text.size() >= sizeof(buffer)) {
+        return false;
+    }
+    memcpy(buffer, text.data(), text.size());
+    buffer[text.size()] = '\0';
+    char *parsedEnd = nullptr;
+    value = strtod(buffer, &parsedEnd);
+    return parsedEnd == buffer + text.size();
+#endif
+}
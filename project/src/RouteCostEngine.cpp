@@ -0,0 +1,193 @@
+#include "../headers/RouteCostEngine.h"
+#include <algorithm>
+#include <limits>
+#include <thread>
+
+using namespace std;
+
+namespace {
+
+const size_t COST_BLOCK_SIZE = 256;
+const uint32_t ANY_BASE_AIRPORT = 0xFFFFFFFFu;
+const uint32_t UNKNOWN_BASE_AIRPORT = 0xFFFFFFFEu;
+
+// Цената на самолет, който не може да изпълни маршрута, е безкрайност,
+// затова изборът на най-евтиния е просто търсене на минимум. Разстоянието
+// на всеки самолет е това от неговата база.
+void computeCostBlock(const double *minRunwayLengths, const double *maxRanges,
+                      const double *fuelPerKmPerSeat, const int32_t *seatCounts,
+                      const uint8_t *operational, const uint32_t *baseAirports, size_t count,
+                      double runwayLength, const double *baseDistances, int passengers,
+                      uint32_t origin, double *costs) {
+    const double infinity = numeric_limits<double>::infinity();
+    for (size_t i = 0; i < count; ++i) {
+        double distance = baseDistances[baseAirports[i]];
+        bool eligible = (minRunwayLengths[i] <= runwayLength) & (maxRanges[i] >= distance) &
+                        (operational[i] != 0) & (seatCounts[i] >= passengers) &
+                        ((origin == ANY_BASE_AIRPORT) | (baseAirports[i] == origin));
+        double cost = fuelPerKmPerSeat[i] * distance * passengers * FUEL_PRICE_PER_LITER;
+        costs[i] = eligible ? cost : infinity;
+    }
+}
+
+}
+
+RouteCostEngine::RouteCostEngine()
+    : minRunwayLengths_(), maxRanges_(), fuelPerKmPerSeat_(), averageSpeeds_(), seatCounts_(),
+      operational_(), baseAirports_(), handles_(), baseAirportCodes_(), baseAirportIds_() {}
+
+RouteCostEngine::RouteCostEngine(const vector<Airplane> &airplanes,
+                                 const vector<SlotHandle<Airplane> > &handles)
+    : minRunwayLengths_(), maxRanges_(), fuelPerKmPerSeat_(), averageSpeeds_(), seatCounts_(),
+      operational_(), baseAirports_(), handles_(handles), baseAirportCodes_(),
+      baseAirportIds_() {
+    minRunwayLengths_.reserve(airplanes.size());
+    maxRanges_.reserve(airplanes.size());
+    fuelPerKmPerSeat_.reserve(airplanes.size());
+    averageSpeeds_.reserve(airplanes.size());
+    seatCounts_.reserve(airplanes.size());
+    operational_.reserve(airplanes.size());
+    baseAirports_.reserve(airplanes.size());
+    for (const auto &airplane : airplanes) {
+        const PlaneClass &planeClass = airplane.getPlaneClassRef();
+        minRunwayLengths_.push_back(planeClass.getMinRunwayLength());
+        maxRanges_.push_back(planeClass.calculateMaxRange());
+        fuelPerKmPerSeat_.push_back(planeClass.getFuelConsumptionPerKmPerSeat());
+        averageSpeeds_.push_back(planeClass.getAverageSpeedKmh());
+        seatCounts_.push_back(planeClass.getSeatCount());
+        operational_.push_back(airplane.isOperational() ? 1 : 0);
+        const string &baseCode = airplane.getBaseAirportCodeRef();
+        auto base = baseAirportIds_.find(baseCode);
+        if (base == baseAirportIds_.end()) {
+            uint32_t id = static_cast<uint32_t>(baseAirportCodes_.size());
+            base = baseAirportIds_.emplace(baseCode, id).first;
+            baseAirportCodes_.push_back(baseCode);
+        }
+        baseAirports_.push_back(base->second);
+    }
+}
+
+size_t RouteCostEngine::size() const { return operational_.size(); }
+
+const vector<string> &RouteCostEngine::getBaseAirportCodes() const { return baseAirportCodes_; }
+
+uint32_t RouteCostEngine::originFilter(const string &originAirportCode) const {
+    if (originAirportCode.empty()) {
+        return ANY_BASE_AIRPORT;
+    }
+    auto found = baseAirportIds_.find(originAirportCode);
+    return found == baseAirportIds_.end() ? UNKNOWN_BASE_AIRPORT : found->second;
+}
+
+RouteCost RouteCostEngine::costAt(size_t position, double distance, int passengers) const {
+    RouteCost routeCost;
+    routeCost.airplane = handles_[position];
+    routeCost.fuelLiters = fuelPerKmPerSeat_[position] * distance * passengers;
+    routeCost.flightHours =
+        averageSpeeds_[position] > 0.0 ? distance / averageSpeeds_[position] : 0.0;
+    routeCost.cost = routeCost.fuelLiters * FUEL_PRICE_PER_LITER;
+    return routeCost;
+}
+
+void RouteCostEngine::evaluate(const Destination &destination, const RouteRequest &route,
+                               const double *baseDistances, vector<RouteCost> &costs) const {
+    int passengers = route.passengers;
+    if (passengers < 0) {
+        return;
+    }
+    uint32_t origin = originFilter(route.originAirportCode);
+    double runwayLength = destination.getRunwayLengthMeters();
+    double blockCosts[COST_BLOCK_SIZE];
+    size_t total = size();
+    for (size_t start = 0; start < total; start += COST_BLOCK_SIZE) {
+        size_t count = min(COST_BLOCK_SIZE, total - start);
+        computeCostBlock(&minRunwayLengths_[start], &maxRanges_[start], &fuelPerKmPerSeat_[start],
+                         &seatCounts_[start], &operational_[start], &baseAirports_[start], count,
+                         runwayLength, baseDistances, passengers, origin, blockCosts);
+        for (size_t i = 0; i < count; ++i) {
+            if (blockCosts[i] != numeric_limits<double>::infinity()) {
+                costs.push_back(
+                    costAt(start + i, baseDistances[baseAirports_[start + i]], passengers));
+            }
+        }
+    }
+}
+
+RouteAssignment RouteCostEngine::findCheapest(const Destination *destination,
+                                              const RouteRequest &route,
+                                              const double *baseDistances) const {
+    int passengers = route.passengers;
+    RouteAssignment assignment;
+    assignment.compatibleAirplanes = 0;
+    assignment.selected = RouteCost{SlotHandle<Airplane>(), 0.0, 0.0, 0.0};
+    if (destination == nullptr) {
+        assignment.status = ROUTE_UNKNOWN_DESTINATION;
+        return assignment;
+    }
+    if (passengers < 0) {
+        assignment.status = ROUTE_INVALID_LOAD;
+        return assignment;
+    }
+
+    double runwayLength = destination->getRunwayLengthMeters();
+    uint32_t origin = originFilter(route.originAirportCode);
+    double blockCosts[COST_BLOCK_SIZE];
+    double bestCost = numeric_limits<double>::infinity();
+    size_t bestPosition = 0;
+    size_t total = size();
+    for (size_t start = 0; start < total; start += COST_BLOCK_SIZE) {
+        size_t count = min(COST_BLOCK_SIZE, total - start);
+        computeCostBlock(&minRunwayLengths_[start], &maxRanges_[start], &fuelPerKmPerSeat_[start],
+                         &seatCounts_[start], &operational_[start], &baseAirports_[start], count,
+                         runwayLength, baseDistances, passengers, origin, blockCosts);
+        for (size_t i = 0; i < count; ++i) {
+            assignment.compatibleAirplanes +=
+                blockCosts[i] != numeric_limits<double>::infinity() ? 1 : 0;
+            if (blockCosts[i] < bestCost) {
+                bestCost = blockCosts[i];
+                bestPosition = start + i;
+            }
+        }
+    }
+
+    if (assignment.compatibleAirplanes == 0) {
+        assignment.status = ROUTE_NO_AIRPLANE;
+        return assignment;
+    }
+    assignment.status = ROUTE_ASSIGNED;
+    assignment.selected =
+        costAt(bestPosition, baseDistances[baseAirports_[bestPosition]], passengers);
+    return assignment;
+}
+
+vector<RouteAssignment> RouteCostEngine::assignCheapest(
+    const vector<const Destination *> &destinations, const vector<RouteRequest> &routes,
+    const vector<double> &baseDistances, unsigned threadCount) const {
+    size_t routeCount = routes.size();
+    vector<RouteAssignment> assignments(routeCount);
+    if (threadCount == 0) {
+        threadCount = max(1u, thread::hardware_concurrency());
+    }
+    size_t workerCount = min<size_t>(threadCount, max<size_t>(routeCount, 1));
+    size_t routesPerWorker = (routeCount + workerCount - 1) / workerCount;
+
+    auto assignRoutes = [&](size_t worker) {
+        size_t firstRoute = worker * routesPerWorker;
+        size_t lastRoute = min(routeCount, firstRoute + routesPerWorker);
+        for (size_t route = firstRoute; route < lastRoute; ++route) {
+            assignments[route] =
+                findCheapest(destinations[route], routes[route],
+                             baseDistances.data() + route * baseAirportCodes_.size());
+        }
+    };
+
+    vector<thread> workers;
+    for (size_t worker = 1; worker < workerCount; ++worker) {
+        workers.emplace_back(assignRoutes, worker);
+    }
+    assignRoutes(0);
+    for (auto &worker : workers) {
+        worker.join();
+    }
+    return assignments;
+}
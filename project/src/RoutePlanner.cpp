@@ -0,0 +1,202 @@
+#include "../headers/RoutePlanner.h"
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <queue>
+
+using namespace std;
+
+namespace {
+
+const uint32_t NO_NODE = numeric_limits<uint32_t>::max();
+
+// Цена на частичен маршрут: основният критерий е броят полети или
+// разстоянието (разходът на гориво е пропорционален на него), а другият
+// разрешава равенствата.
+struct SearchCost {
+    double primary;
+    double secondary;
+
+    bool operator<(const SearchCost &other) const {
+        return primary != other.primary ? primary < other.primary
+                                        : secondary < other.secondary;
+    }
+};
+
+SearchCost legCost(RoutingObjective objective, double distance) {
+    return objective == ROUTING_MIN_STOPS ? SearchCost{1.0, distance} : SearchCost{distance, 1.0};
+}
+
+// Разстоянието по права до целта не надценява остатъка, а броят полети не
+// е по-малък от него, разделено на обхвата, така че A* остава точен.
+SearchCost remainingCost(RoutingObjective objective, double distanceToTarget, double maxRange) {
+    double legs = maxRange > 0.0 ? ceil(distanceToTarget / maxRange) : 0.0;
+    return objective == ROUTING_MIN_STOPS ? SearchCost{legs, distanceToTarget}
+                                          : SearchCost{distanceToTarget, legs};
+}
+
+}
+
+RoutePlanner::RoutePlanner(const vector<Destination> &destinations)
+    : destinations_(destinations), positionsByCode_(), geoIndex_(destinations_), graphs_() {
+    positionsByCode_.reserve(destinations_.size());
+    for (size_t i = 0; i < destinations_.size(); ++i) {
+        positionsByCode_.emplace(destinations_[i].getCodeRef(), static_cast<uint32_t>(i));
+    }
+}
+
+size_t RoutePlanner::size() const { return destinations_.size(); }
+
+size_t RoutePlanner::getCachedClassCount() const { return graphs_.size(); }
+
+shared_ptr<const RoutePlanner::ReachabilityGraph>
+RoutePlanner::buildGraph(const PlaneClass &planeClass) const {
+    shared_ptr<ReachabilityGraph> graph = make_shared<ReachabilityGraph>();
+    graph->nodeByPosition.assign(destinations_.size(), NO_NODE);
+    for (size_t i = 0; i < destinations_.size(); ++i) {
+        const Destination &destination = destinations_[i];
+        if (!destination.hasCoordinates() ||
+            !planeClass.isCompatibleWithRunway(destination.getRunwayLengthMeters())) {
+            continue;
+        }
+        graph->nodeByPosition[i] = static_cast<uint32_t>(graph->positions.size());
+        graph->positions.push_back(static_cast<uint32_t>(i));
+    }
+
+    // Съседите в обхвата се търсят в пространствения индекс; точното
+    // разстояние се смята само за върнатите кандидати.
+    double maxRange = planeClass.calculateMaxRange();
+    size_t nodeCount = graph->positions.size();
+    vector<vector<pair<uint32_t, double> > > adjacency(nodeCount);
+    vector<uint32_t> nearby;
+    for (size_t u = 0; u < nodeCount; ++u) {
+        const Destination &from = destinations_[graph->positions[u]];
+        nearby.clear();
+        geoIndex_.findWithinKm(from, maxRange, nearby);
+        for (uint32_t position : nearby) {
+            uint32_t v = graph->nodeByPosition[position];
+            if (v == NO_NODE || v <= u) {
+                continue;
+            }
+            double distance = from.distanceToKm(destinations_[position]);
+            if (distance <= maxRange) {
+                adjacency[u].push_back(make_pair(v, distance));
+                adjacency[v].push_back(make_pair(static_cast<uint32_t>(u), distance));
+            }
+        }
+    }
+
+    graph->firstEdge.reserve(nodeCount + 1);
+    graph->firstEdge.push_back(0);
+    for (const auto &edges : adjacency) {
+        for (const auto &edge : edges) {
+            graph->targets.push_back(edge.first);
+            graph->distances.push_back(edge.second);
+        }
+        graph->firstEdge.push_back(static_cast<uint32_t>(graph->targets.size()));
+    }
+    return graph;
+}
+
+shared_ptr<const RoutePlanner::ReachabilityGraph>
+RoutePlanner::graphFor(const PlaneClass &planeClass) const {
+    auto found = graphs_.find(planeClass.getClassIdRef());
+    if (found != graphs_.end()) {
+        return found->second;
+    }
+    shared_ptr<const ReachabilityGraph> graph = buildGraph(planeClass);
+    graphs_.emplace(planeClass.getClassIdRef(), graph);
+    return graph;
+}
+
+FlightPlan RoutePlanner::planFlight(const PlaneClass &planeClass, const string &originCode,
+                                    const string &targetCode, RoutingObjective objective) const {
+    FlightPlan plan;
+    plan.totalDistanceKm = 0.0;
+    plan.totalFuelLiters = 0.0;
+
+    auto origin = positionsByCode_.find(originCode);
+    auto target = positionsByCode_.find(targetCode);
+    if (origin == positionsByCode_.end() || target == positionsByCode_.end()) {
+        plan.status = FLIGHT_UNKNOWN_AIRPORT;
+        return plan;
+    }
+    const Destination &targetDestination = destinations_[target->second];
+    if (!destinations_[origin->second].hasCoordinates() || !targetDestination.hasCoordinates()) {
+        plan.status = FLIGHT_NO_COORDINATES;
+        return plan;
+    }
+    shared_ptr<const ReachabilityGraph> graph = graphFor(planeClass);
+    uint32_t start = graph->nodeByPosition[origin->second];
+    uint32_t goal = graph->nodeByPosition[target->second];
+    if (start == NO_NODE || goal == NO_NODE) {
+        plan.status = FLIGHT_RUNWAY_TOO_SHORT;
+        return plan;
+    }
+
+    size_t nodeCount = graph->positions.size();
+    double maxRange = planeClass.calculateMaxRange();
+    const double infinity = numeric_limits<double>::infinity();
+    vector<SearchCost> cost(nodeCount, SearchCost{infinity, infinity});
+    vector<uint32_t> parent(nodeCount, NO_NODE);
+    vector<uint8_t> closed(nodeCount, 0);
+    typedef pair<SearchCost, uint32_t> QueueEntry;
+    priority_queue<QueueEntry, vector<QueueEntry>, greater<QueueEntry> > queue;
+    auto estimate = [&](uint32_t node) {
+        double distance = destinations_[graph->positions[node]].distanceToKm(targetDestination);
+        return remainingCost(objective, distance, maxRange);
+    };
+
+    cost[start] = SearchCost{0.0, 0.0};
+    queue.push(QueueEntry(estimate(start), start));
+    while (!queue.empty()) {
+        uint32_t node = queue.top().second;
+        queue.pop();
+        if (closed[node] != 0) {
+            continue;
+        }
+        closed[node] = 1;
+        if (node == goal) {
+            break;
+        }
+        for (uint32_t edge = graph->firstEdge[node]; edge < graph->firstEdge[node + 1]; ++edge) {
+            uint32_t next = graph->targets[edge];
+            if (closed[next] != 0) {
+                continue;
+            }
+            SearchCost step = legCost(objective, graph->distances[edge]);
+            SearchCost candidate = {cost[node].primary + step.primary,
+                                    cost[node].secondary + step.secondary};
+            if (candidate < cost[next]) {
+                cost[next] = candidate;
+                parent[next] = node;
+                SearchCost remaining = estimate(next);
+                queue.push(QueueEntry(SearchCost{candidate.primary + remaining.primary,
+                                                 candidate.secondary + remaining.secondary},
+                                      next));
+            }
+        }
+    }
+    if (closed[goal] == 0) {
+        plan.status = FLIGHT_UNREACHABLE;
+        return plan;
+    }
+
+    vector<uint32_t> path;
+    for (uint32_t node = goal; node != NO_NODE; node = parent[node]) {
+        path.push_back(node);
+    }
+    reverse(path.begin(), path.end());
+    for (size_t i = 1; i < path.size(); ++i) {
+        const Destination &from = destinations_[graph->positions[path[i - 1]]];
+        const Destination &to = destinations_[graph->positions[path[i]]];
+        double distance = from.distanceToKm(to);
+        double fuel = planeClass.calculateFuelConsumption(distance, planeClass.getSeatCount());
+        plan.legs.push_back(FlightLeg{from.getCodeRef(), to.getCodeRef(), distance, fuel});
+        plan.totalDistanceKm += distance;
+        plan.totalFuelLiters += fuel;
+    }
+    plan.status = FLIGHT_PLANNED;
+    return plan;
+}
@@ -0,0 +1,46 @@
+#include "../headers/SnapshotCompatibility.h"
+
+using namespace std;
+
+SnapshotCompatibility::SnapshotCompatibility()
+    : entries_(), baseAirportCodes_(), baseAirportIds_() {}
+
+size_t SnapshotCompatibility::size() const { return entries_.size(); }
+
+const PersistentVector<SnapshotCompatibility::Entry> &SnapshotCompatibility::getEntries() const {
+    return entries_;
+}
+
+const PersistentVector<string> &SnapshotCompatibility::getBaseAirportCodes() const {
+    return baseAirportCodes_;
+}
+
+void SnapshotCompatibility::set(size_t position, const Airplane &airplane) {
+    const string &baseCode = airplane.getBaseAirportCodeRef();
+    const uint32_t *base = baseAirportIds_.find(baseCode);
+    uint32_t baseAirport;
+    if (base == nullptr) {
+        baseAirport = static_cast<uint32_t>(baseAirportCodes_.size());
+        baseAirportIds_.set(baseCode, baseAirport);
+        baseAirportCodes_.push_back(baseCode);
+    } else {
+        baseAirport = *base;
+    }
+
+    const PlaneClass &planeClass = airplane.getPlaneClassRef();
+    Entry entry = {planeClass.getMinRunwayLength(), planeClass.calculateMaxRange(), baseAirport,
+                   airplane.isOperational()};
+    if (position == entries_.size()) {
+        entries_.push_back(entry);
+    } else {
+        entries_.set(position, entry);
+    }
+}
+
+void SnapshotCompatibility::popBack() { entries_.pop_back(); }
+
+void SnapshotCompatibility::clear() {
+    entries_.clear();
+    baseAirportCodes_.clear();
+    baseAirportIds_.clear();
+}
@@ -1,11 +1,143 @@
 #include <iostream>
 #include "../headers/FleetManager.h"
 #include "../headers/Validator.h"
+#include "../headers/FleetCsv.h"
+#include "../headers/CommandInterpreter.h"
+#include "../headers/QueryServer.h"
+#include <csignal>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
 
 using namespace std;
 
-int main() {
+void printUsage(const char *program) {
+    cout << "Употреба:" << endl;
+    cout << "  " << program << endl;
+    cout << "  " << program << " --import classes|airplanes|destinations <файл> [файл за отхвърлени]"
+         << endl;
+    cout << "  " << program << " --export classes|airplanes|destinations <файл>" << endl;
+    cout << "  " << program << " --export-compatible <писта> <разстояние> <файл>" << endl;
+    cout << "  " << program << " --plan-routes <файл с маршрути> <файл с резултат>" << endl;
+    cout << "  " << program << " --assign-routes <файл с маршрути> <файл с резултат>" << endl;
+    cout << "  " << program << " --batch [файл с команди]" << endl;
+    cout << "  " << program << " --serve <път до сокет>" << endl;
+}
+
+void handleShutdownSignal(int) { QueryServer::requestShutdown(); }
+
+int runServer(FleetManager &manager, const string &socketPath) {
+    manager.loadAllData();
+    manager.displayLoadErrors(cerr);
+
+    QueryServer server(manager, socketPath);
+    if (!server.start()) {
+        cerr << "Сокетът " << socketPath << " не може да бъде отворен." << endl;
+        return 1;
+    }
+
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = handleShutdownSignal;
+    sigemptyset(&action.sa_mask);
+    sigaction(SIGINT, &action, nullptr);
+    sigaction(SIGTERM, &action, nullptr);
+
+    cerr << "Сървърът слуша на " << socketPath << endl;
+    server.run();
+    server.stop();
+    return 0;
+}
+
+int runBatch(FleetManager &manager, int argc, char *argv[]) {
+    ifstream script;
+    if (argc == 3) {
+        script.open(argv[2]);
+        if (!script.is_open()) {
+            cerr << "Файлът " << argv[2] << " не може да бъде отворен." << endl;
+            return 1;
+        }
+    }
+
+    manager.loadAllData();
+    manager.displayLoadErrors(cerr);
+    manager.enableJournal(1000);
+
+    ios::sync_with_stdio(false);
+    CommandInterpreter interpreter(manager);
+    interpreter.run(argc == 3 ? static_cast<istream &>(script) : cin, cout);
+    return interpreter.getFailedCount() == 0 ? 0 : 2;
+}
+
+int runCommandLine(FleetManager &manager, int argc, char *argv[]) {
+    string command = argv[1];
+    if (command == "--batch" && argc <= 3) {
+        return runBatch(manager, argc, argv);
+    }
+    if (command == "--serve" && argc == 3) {
+        return runServer(manager, argv[2]);
+    }
+
+    manager.loadAllData();
+    manager.displayLoadErrors(cerr);
+
+    if (command == "--import" && (argc == 4 || argc == 5)) {
+        ImportSummary summary;
+        string rejectsFile = argc == 5 ? argv[4] : "";
+        if (!FleetCsv::importFile(manager, argv[2], argv[3], rejectsFile, summary)) {
+            cerr << "Грешка при импортиране от " << argv[3] << endl;
+            return 1;
+        }
+        cout << "Импортирани: " << summary.imported << ", дубликати: " << summary.duplicates
+             << ", отхвърлени: " << summary.rejected << endl;
+        if (!manager.saveAllData()) {
+            cerr << "Грешка при запазване на данните." << endl;
+            return 1;
+        }
+        return 0;
+    }
+    if (command == "--export" && argc == 4) {
+        if (!FleetCsv::exportFile(manager, argv[2], argv[3])) {
+            cerr << "Грешка при експортиране в " << argv[3] << endl;
+            return 1;
+        }
+        return 0;
+    }
+    if (command == "--export-compatible" && argc == 5) {
+        if (!FleetCsv::exportCompatibleAirplanes(manager, atof(argv[2]), atof(argv[3]),
+                                                 argv[4])) {
+            cerr << "Грешка при експортиране в " << argv[4] << endl;
+            return 1;
+        }
+        return 0;
+    }
+    if (command == "--plan-routes" && argc == 4) {
+        if (!FleetCsv::planRoutesFile(manager, argv[2], argv[3])) {
+            cerr << "Грешка при планиране на маршрутите от " << argv[2] << endl;
+            return 1;
+        }
+        return 0;
+    }
+    if (command == "--assign-routes" && argc == 4) {
+        FleetAssignment assignment;
+        if (!FleetCsv::assignRoutesFile(manager, argv[2], argv[3], assignment)) {
+            cerr << "Грешка при разпределяне на самолетите по маршрутите от " << argv[2] << endl;
+            return 1;
+        }
+        cout << "Покрити маршрути: " << assignment.assignedRoutes << " от "
+             << assignment.routes.size() << ", обща цена: " << assignment.totalCost << endl;
+        return 0;
+    }
+
+    printUsage(argv[0]);
+    return 1;
+}
+
+int main(int argc, char *argv[]) {
     FleetManager manager("България Еър Флот", "./data");
+    if (argc > 1) {
+        return runCommandLine(manager, argc, argv);
+    }
 
     cout << "СИСТЕМА ЗА УПРАВЛЕНИЕ НА АВИОФЛОТА" << endl;
     cout << "Добре дошли в системата за управление на флота!" << endl;
@@ -15,10 +147,13 @@ int main() {
     if (!manager.loadAllData()) {
         cout << "Не са намерени съществуващи данни или зареждането е неуспешно." << endl;
         cout << "Използвайте опция 8 за добавяне на примерни данни." << endl;
+        manager.displayLoadErrors(cout);
     } else {
+        manager.displayLoadErrors(cout);
         cout << "Данните са заредени успешно!" << endl;
         cout << manager;
     }
+    manager.enableJournal(1000);
 
     int choice;
     do {
@@ -51,11 +186,12 @@ int main() {
                 break;
             case 7:
                 cout << "\nЗареждане на данните..." << endl;
-                manager.clearAllData();
                 if (!manager.loadAllData()) {
                     cout << "Внимание: Някои данни може да не са заредени." << endl;
+                    manager.displayLoadErrors(cout);
                     break;
                 }
+                manager.displayLoadErrors(cout);
                 cout << "Всички данни са заредени успешно!" << endl;
                 cout << manager;
                 break;
@@ -67,6 +203,8 @@ int main() {
                 int saveChoice = Validator::getValidInt("");
                 if (saveChoice == 1 && manager.saveAllData()) {
                     cout << "Данните са запазени успешно!" << endl;
+                } else if (saveChoice != 1) {
+                    manager.discardJournal();
                 }
                 cout << "\nБлагодарим ви, че използвахте системата за управление на флота!" << endl;
                 cout << "Довиждане!" << endl;